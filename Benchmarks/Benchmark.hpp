@@ -0,0 +1,44 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Benchmark.hpp
+ * @date 2024-08-03
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace ra::bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Prevents the compiler from optimizing away the computation of `value`.
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Runs `func` once to warm up caches and then `iterations` more times.
+ *
+ * @return Average duration of a single run in nanoseconds.
+ */
+template <typename Func>
+double MeasureNs(uint32_t iterations, Func&& func) {
+  func();
+
+  const auto start = Clock::now();
+  for (uint32_t i = 0U; i < iterations; ++i) {
+    func();
+  }
+  const auto end = Clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+}  // namespace ra::bench
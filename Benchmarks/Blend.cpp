@@ -0,0 +1,245 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Blend.cpp
+ * @date 2024-08-15
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Benchmark.hpp>
+
+#include <Render/BlendKernels.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ra;
+
+static constexpr uint32_t kIterations = 2000U;
+static constexpr size_t   kRowSize    = 1024U;
+
+/* Fixed point blending must stay within one 8-bit step of exact blending */
+static constexpr double kMaxErrorFixed = 1.0;
+
+/* Golden frame, layers of coverage spans over a background. Every layer is rounded to 8 bits, so even correctly rounded
+ * blending may drift from the exact frame by half a step per layer */
+static constexpr size_t kFrameSize     = 64U;
+static constexpr size_t kFrameLayers   = 16U;
+static constexpr double kMaxFrameError = 0.5 * kFrameLayers;
+
+/**
+ * Previous per-pixel path, straight alpha color and coverage blended in float, which is what every line, particle and
+ * glyph pixel used to go through.
+ */
+static void BlendSpanFloat(render::Color* dst, render::Color color, const uint8_t* coverage, size_t count) {
+  const math::Vec4f colorf(color);
+
+  for (size_t i = 0U; i < count; ++i) {
+    const float alpha = colorf.a * coverage[i] / 255.0f;
+    math::Vec4f old(dst[i]);
+    math::Vec4f result;
+
+    result.rgb = colorf.rgb * alpha + old.rgb * (1.0f - alpha);
+    result.a   = alpha + old.a * (1.0f - alpha);
+
+    dst[i] = render::Color(result);
+  }
+}
+
+/* Exact result of blending channel `c` with alpha `a` over channel `d`, 8-bit values */
+static double ReferenceChannel(uint32_t c, uint32_t a, uint32_t d) {
+  return c * a / 255.0 + d * (255.0 - a) / 255.0;
+}
+
+/* Byte `channel` of the color, alpha is the last one */
+static uint32_t Channel(render::Color color, size_t channel) {
+  return (color.Value() >> (channel * 8U)) & 0xFFU;
+}
+
+struct FrameError {
+  double fixed{0.0};
+  double floating{0.0};
+};
+
+/**
+ * Draws kFrameLayers layers of random colors with horizontal coverage gradients over an opaque gradient background with
+ * BlendSpanPremultiplied, with BlendSpanFloat and in double precision without any rounding in between.
+ *
+ * @return Max difference of a channel between each of the 8-bit frames and the exact one.
+ */
+static FrameError GoldenFrameError(std::mt19937& random) {
+  std::uniform_int_distribution<uint32_t> random_byte(0U, 255U);
+
+  std::vector<render::Color> frame(kFrameSize * kFrameSize);
+  std::vector<render::Color> frame_float;
+  std::vector<double>        reference(frame.size() * 4U);
+
+  for (size_t i = 0U; i < frame.size(); ++i) {
+    const auto x = static_cast<uint32_t>(i % kFrameSize * 4U);
+    const auto y = static_cast<uint32_t>(i / kFrameSize * 4U);
+
+    frame[i] = render::Color(x, y, 255U - x, 255U);
+    for (size_t channel = 0U; channel < 4U; ++channel) {
+      reference[i * 4U + channel] = Channel(frame[i], channel);
+    }
+  }
+
+  /* The background is opaque, so straight and premultiplied alpha frames are the same */
+  frame_float = frame;
+
+  std::vector<uint8_t> coverage(kFrameSize);
+
+  for (size_t layer = 0U; layer < kFrameLayers; ++layer) {
+    const auto straight = render::Color(random_byte(random), random_byte(random), random_byte(random),
+                                        random_byte(random));
+    const auto color    = render::PremultiplyAlpha(straight);
+
+    for (size_t x = 0U; x < kFrameSize; ++x) {
+      coverage[x] = static_cast<uint8_t>(x * 255U / (kFrameSize - 1U));
+    }
+
+    for (size_t y = layer; y < kFrameSize; ++y) {
+      render::BlendSpanPremultiplied(&frame[y * kFrameSize], color, coverage.data(), kFrameSize);
+      BlendSpanFloat(&frame_float[y * kFrameSize], straight, coverage.data(), kFrameSize);
+
+      for (size_t x = 0U; x < kFrameSize; ++x) {
+        const double alpha = straight.A() / 255.0 * coverage[x] / 255.0;
+
+        for (size_t channel = 0U; channel < 4U; ++channel) {
+          const double src = (channel == 3U) ? alpha * 255.0 : Channel(straight, channel) * alpha;
+          double&      dst = reference[(y * kFrameSize + x) * 4U + channel];
+
+          dst = src + dst * (1.0 - alpha);
+        }
+      }
+    }
+  }
+
+  FrameError error;
+  for (size_t i = 0U; i < frame.size(); ++i) {
+    for (size_t channel = 0U; channel < 4U; ++channel) {
+      const double exact = reference[i * 4U + channel];
+
+      error.fixed    = std::max(error.fixed, std::abs(Channel(frame[i], channel) - exact));
+      error.floating = std::max(error.floating, std::abs(Channel(frame_float[i], channel) - exact));
+    }
+  }
+
+  return error;
+}
+
+int main() {
+  /* Fixed point error, exhaustive over all (color, alpha, destination) channel triples */
+  double   max_error_fixed  = 0.0;
+  double   sum_error_fixed  = 0.0;
+  double   max_error_float  = 0.0;
+  uint32_t off_by_one_fixed = 0U;
+
+  for (uint32_t a = 0U; a < 256U; ++a) {
+    for (uint32_t c = 0U; c < 256U; ++c) {
+      const uint32_t premultiplied = render::MulDiv255(c, a);
+
+      for (uint32_t d = 0U; d < 256U; ++d) {
+        const double reference = ReferenceChannel(c, a, d);
+        const double fixed     = premultiplied + render::MulDiv255(d, 255U - a);
+        const double floating  = std::floor((c / 255.0f * (a / 255.0f) + d / 255.0f * (1.0f - a / 255.0f)) * 255.0f);
+
+        max_error_fixed = std::max(max_error_fixed, std::abs(fixed - reference));
+        max_error_float = std::max(max_error_float, std::abs(floating - reference));
+        sum_error_fixed += std::abs(fixed - reference);
+        off_by_one_fixed += std::abs(fixed - std::round(reference)) > 0.0;
+      }
+    }
+  }
+
+  /* SIMD kernels must match the scalar definition bit for bit */
+  std::mt19937                            random(42U);
+  std::uniform_int_distribution<uint32_t> random_byte(0U, 255U);
+
+  std::vector<render::Color> src(kRowSize);
+  std::vector<render::Color> dst(kRowSize);
+  std::vector<render::Color> expected(kRowSize);
+  std::vector<uint8_t>       coverage(kRowSize);
+
+  for (size_t i = 0U; i < kRowSize; ++i) {
+    const auto straight = render::Color(random_byte(random), random_byte(random), random_byte(random),
+                                        random_byte(random));
+
+    src[i]      = render::PremultiplyAlpha(straight);
+    dst[i]      = render::Color(random_byte(random), random_byte(random), random_byte(random), random_byte(random));
+    coverage[i] = static_cast<uint8_t>(random_byte(random));
+  }
+
+  const auto color = render::PremultiplyAlpha(render::Color(200U, 120U, 40U, 180U));
+  size_t     mismatches = 0U;
+
+  auto row = dst;
+  render::BlendRowPremultiplied(row.data(), src.data(), kRowSize - 3U);
+  for (size_t i = 0U; i < kRowSize; ++i) {
+    expected[i] = (i < kRowSize - 3U) ? render::BlendPremultiplied(dst[i], src[i]) : dst[i];
+    mismatches += row[i].Value() != expected[i].Value();
+  }
+
+  row = dst;
+  render::BlendSpanPremultiplied(row.data(), color, coverage.data(), kRowSize - 3U);
+  for (size_t i = 0U; i < kRowSize; ++i) {
+    expected[i] = (i < kRowSize - 3U) ? render::BlendPremultiplied(dst[i], render::ScalePremultiplied(color, coverage[i]))
+                                      : dst[i];
+    mismatches += row[i].Value() != expected[i].Value();
+  }
+
+  const auto frame_error = GoldenFrameError(random);
+
+  /* Throughput of a coverage span, as drawn for lines and particles */
+  const auto straight_color = render::Color(200U, 120U, 40U, 180U);
+
+  row             = dst;
+  double float_ns = bench::MeasureNs(kIterations, [&]() {
+    BlendSpanFloat(row.data(), straight_color, coverage.data(), kRowSize);
+    bench::DoNotOptimize(row.data());
+  });
+
+  row             = dst;
+  double fixed_ns = bench::MeasureNs(kIterations, [&]() {
+    render::BlendSpanPremultiplied(row.data(), color, coverage.data(), kRowSize);
+    bench::DoNotOptimize(row.data());
+  });
+
+  row           = dst;
+  double row_ns = bench::MeasureNs(kIterations, [&]() {
+    render::BlendRowPremultiplied(row.data(), src.data(), kRowSize);
+    bench::DoNotOptimize(row.data());
+  });
+
+  std::printf("Blend error against exact blending, over all 2^24 channel triples\n");
+  std::printf("%-28s %10s %10s\n", "path", "max", "mean");
+  std::printf("%-28s %10.3f %10s\n", "float, straight alpha", max_error_float, "-");
+  std::printf("%-28s %10.3f %10.4f\n", "fixed point, premultiplied", max_error_fixed,
+              sum_error_fixed / (256.0 * 256.0 * 256.0));
+  std::printf("Fixed point differs from the correctly rounded result in %.2f%% of cases\n",
+              100.0 * off_by_one_fixed / (256.0 * 256.0 * 256.0));
+  std::printf("SIMD kernels mismatching the scalar definition: %zu pixels\n", mismatches);
+  std::printf("Golden frame of %zu layers over %zux%zu pixels, max error against exact blending: %.3f fixed point, "
+              "%.3f float\n\n", kFrameLayers, kFrameSize, kFrameSize, frame_error.fixed, frame_error.floating);
+
+  std::printf("%-28s %14s\n", "kernel", "ns/pixel");
+  std::printf("%-28s %14.3f\n", "span, float", float_ns / kRowSize);
+  std::printf("%-28s %14.3f\n", "span, fixed point", fixed_ns / kRowSize);
+  std::printf("%-28s %14.3f\n", "row, fixed point", row_ns / kRowSize);
+
+  bool ok = (mismatches == 0U);
+
+  if (max_error_fixed > kMaxErrorFixed) {
+    std::printf("FAILED: fixed point max error %.3f exceeds %.3f\n", max_error_fixed, kMaxErrorFixed);
+    ok = false;
+  }
+
+  if (frame_error.fixed > kMaxFrameError) {
+    std::printf("FAILED: golden frame max error %.3f exceeds %.3f\n", frame_error.fixed, kMaxFrameError);
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file FastTrig.cpp
+ * @date 2024-08-11
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Benchmark.hpp>
+
+#include <Math/FastTrig.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace ra;
+
+static constexpr size_t   kSamplesCount = 1U << 20U;
+static constexpr uint32_t kIterations   = 50U;
+
+static std::vector<float> Samples(float range) {
+  std::vector<float> samples(kSamplesCount);
+  for (size_t i = 0U; i < kSamplesCount; ++i) {
+    samples[i] = -range + 2.0f * range * static_cast<float>(i) / static_cast<float>(kSamplesCount - 1U);
+  }
+
+  return samples;
+}
+
+static void ReportAccuracy(float range) {
+  const auto samples = Samples(range);
+
+  double max_sin_error = 0.0;
+  double max_cos_error = 0.0;
+
+  for (float x : samples) {
+    /* Reference is computed in double, so libm's own float rounding doesn't count against the approximation */
+    max_sin_error = std::max(max_sin_error, std::abs(math::FastSin(x) - std::sin(static_cast<double>(x))));
+    max_cos_error = std::max(max_cos_error, std::abs(math::FastCos(x) - std::cos(static_cast<double>(x))));
+  }
+
+  std::printf("[%9.1f, %9.1f] %14.3e %14.3e\n", -range, range, max_sin_error, max_cos_error);
+}
+
+int main() {
+  std::printf("Accuracy, max absolute error against libm (double), %zu samples\n", kSamplesCount);
+  std::printf("%-22s %14s %14s\n", "range", "sin", "cos");
+
+  for (float range : {3.2f, 100.0f, 1e4f, 1e5f}) {
+    ReportAccuracy(range);
+  }
+
+  /* Performance */
+  const auto         samples = Samples(1e3f);
+  std::vector<float> sin(kSamplesCount);
+  std::vector<float> cos(kSamplesCount);
+
+  double libm_ns = bench::MeasureNs(kIterations, [&]() {
+    for (size_t i = 0U; i < kSamplesCount; ++i) {
+      sin[i] = std::sin(samples[i]);
+    }
+    bench::DoNotOptimize(sin.data());
+  });
+
+  double scalar_ns = bench::MeasureNs(kIterations, [&]() {
+    for (size_t i = 0U; i < kSamplesCount; ++i) {
+      sin[i] = math::FastSin(samples[i]);
+      bench::DoNotOptimize(sin[i]);
+    }
+  });
+
+  double batch_ns = bench::MeasureNs(kIterations, [&]() {
+    math::FastSin(samples.data(), sin.data(), kSamplesCount);
+    bench::DoNotOptimize(sin.data());
+  });
+
+  double libm_sincos_ns = bench::MeasureNs(kIterations, [&]() {
+    for (size_t i = 0U; i < kSamplesCount; ++i) {
+      sin[i] = std::sin(samples[i]);
+      cos[i] = std::cos(samples[i]);
+    }
+    bench::DoNotOptimize(sin.data());
+    bench::DoNotOptimize(cos.data());
+  });
+
+  double batch_sincos_ns = bench::MeasureNs(kIterations, [&]() {
+    math::FastSinCos(samples.data(), sin.data(), cos.data(), kSamplesCount);
+    bench::DoNotOptimize(sin.data());
+    bench::DoNotOptimize(cos.data());
+  });
+
+  std::printf("\nPerformance, %zu samples in [-1000, 1000]\n", kSamplesCount);
+  std::printf("%-22s %14s\n", "method", "ns/value");
+  std::printf("%-22s %14.3f\n", "std::sin", libm_ns / kSamplesCount);
+  std::printf("%-22s %14.3f\n", "FastSin (scalar)", scalar_ns / kSamplesCount);
+  std::printf("%-22s %14.3f\n", "FastSin (batch)", batch_ns / kSamplesCount);
+  std::printf("%-22s %14.3f\n", "std::sin + std::cos", libm_sincos_ns / kSamplesCount);
+  std::printf("%-22s %14.3f\n", "FastSinCos (batch)", batch_sincos_ns / kSamplesCount);
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file ParticleUpdate.cpp
+ * @date 2024-08-03
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Benchmark.hpp>
+
+#include <JobSystem/Executor.hpp>
+#include <Render/ParticleSystem.hpp>
+
+#include <cstdio>
+#include <vector>
+
+using namespace ra;
+
+static constexpr size_t   kSystemsCount       = 1024U;
+static constexpr size_t   kParticlesPerSystem = 1024U;
+static constexpr size_t   kLargeSystemSize    = 100000U;
+static constexpr uint32_t kIterations         = 50U;
+
+int main() {
+  const render::ParticleSystem::ParticleSpecs specs{
+    .origin             = math::Vec2f(0.0f),
+    .velocity           = math::Vec2f(1.0f, 2.0f),
+    .velocity_variation = math::Vec2f(1.0f),
+
+    .color_begin = math::Vec4f(0.9f, 0.8f, 0.1f, 1.0f),
+    .color_end   = math::Vec4f(1.0f, 0.4f, 0.1f, 0.0f),
+
+    .size_begin     = 0.05f,
+    .size_end       = 0.3f,
+    .size_variation = 0.05f,
+
+    /* Particles must outlive the benchmark, so that all of them are updated each iteration */
+    .lifetime = 1e6f
+  };
+
+  std::vector<render::ParticleSystem> systems;
+  systems.reserve(kSystemsCount);
+
+  for (size_t i = 0U; i < kSystemsCount; ++i) {
+    auto& system = systems.emplace_back(kParticlesPerSystem);
+    system.EmitBurst(specs, kParticlesPerSystem);
+    system.Update(0.0f);  // Merges the burst
+  }
+
+  const size_t particles_count = kSystemsCount * kParticlesPerSystem;
+
+  std::printf("ParticleSystem::Update, %zu systems x %zu particles\n", kSystemsCount, kParticlesPerSystem);
+  std::printf("%-10s %14s %14s\n", "kernel", "ms/update", "ns/particle");
+
+  for (auto kernel : {render::ParticleKernel::Scalar, render::ParticleKernel::AVX2}) {
+    if (!render::IsSupported(kernel)) {
+      std::printf("%-10s %14s %14s\n", render::ToString(kernel), "unsupported", "-");
+      continue;
+    }
+
+    double ns = bench::MeasureNs(kIterations, [&]() {
+      for (auto& system : systems) {
+        system.Update(1e-6f, kernel);
+      }
+    });
+
+    std::printf("%-10s %14.3f %14.3f\n", render::ToString(kernel), ns * 1e-6, ns / particles_count);
+  }
+
+  /* Single large system, serial vs chunked jobs */
+  render::ParticleSystem large_system(kLargeSystemSize);
+  large_system.EmitBurst(specs, kLargeSystemSize);
+  large_system.Update(0.0f);
+
+  job::Executor executor;
+
+  double serial_ns = bench::MeasureNs(kIterations, [&]() {
+    large_system.Update(1e-6f);
+  });
+
+  double jobs_ns = bench::MeasureNs(kIterations, [&]() {
+    large_system.Update(1e-6f, executor);
+    executor.WaitIdle();
+  });
+
+  executor.Stop();
+
+  std::printf("\nParticleSystem::Update, 1 system x %zu particles, %zu threads\n", kLargeSystemSize,
+              executor.ThreadCount());
+  std::printf("%-10s %14s %14s\n", "mode", "ms/update", "ns/particle");
+  std::printf("%-10s %14.3f %14.3f\n", "serial", serial_ns * 1e-6, serial_ns / kLargeSystemSize);
+  std::printf("%-10s %14.3f %14.3f\n", "jobs", jobs_ns * 1e-6, jobs_ns / kLargeSystemSize);
+
+  /* Emission is deferred until the next update, so each burst is measured together with the update merging it. The
+   * pool only fits one burst, which keeps the cost of integration small. */
+  constexpr size_t kBurstSize = 32U;
+
+  render::ParticleSystem emitter(kBurstSize);
+
+  double single_ns = bench::MeasureNs(kIterations, [&]() {
+    for (size_t i = 0U; i < kParticlesPerSystem; i += kBurstSize) {
+      for (size_t j = 0U; j < kBurstSize; ++j) {
+        emitter.EmitParticle(specs);
+      }
+      emitter.Update(1e-6f);
+    }
+  });
+
+  double burst_ns = bench::MeasureNs(kIterations, [&]() {
+    for (size_t i = 0U; i < kParticlesPerSystem; i += kBurstSize) {
+      emitter.EmitBurst(specs, kBurstSize);
+      emitter.Update(1e-6f);
+    }
+  });
+
+  std::printf("\nParticleSystem emission and merge, %zu particles\n", kParticlesPerSystem);
+  std::printf("%-10s %14s\n", "method", "ns/particle");
+  std::printf("%-10s %14.3f\n", "single", single_ns / kParticlesPerSystem);
+  std::printf("%-10s %14.3f\n", "burst", burst_ns / kParticlesPerSystem);
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file StarBackground.cpp
+ * @date 2024-08-12
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Benchmark.hpp>
+
+#include <Game/StarBackground.hpp>
+#include <JobSystem/Executor.hpp>
+#include <Math/FastTrig.hpp>
+#include <Render/Image.hpp>
+#include <Render/Renderer.hpp>
+
+#include <cstdio>
+
+using namespace ra;
+
+static constexpr uint32_t kIterations = 100U;
+
+/**
+ * Previous representation, dense images with 20 bytes per pixel read by a per-pixel shader. Only kept here as the
+ * baseline: the shader reads every byte of both images each frame.
+ */
+struct DenseStarsData {
+  render::Image<math::Vec4f> image_dist1;  // x = distr, yz = pos, w = star_value
+  render::Image<float>       image_dist2;
+};
+
+static DenseStarsData MakeDenseStarsData(math::Vec2u extent) {
+  DenseStarsData data{.image_dist1 = render::Image<math::Vec4f>(extent), .image_dist2 = render::Image<float>(extent)};
+
+  /* Contents don't matter for bandwidth, no pixel is a star, so that the baseline is as cheap as it can be */
+  auto view_dist1 = data.image_dist1.CreateView();
+  auto view_dist2 = data.image_dist2.CreateView();
+  for (uint32_t y = 0U; y < extent.y; ++y) {
+    for (uint32_t x = 0U; x < extent.x; ++x) {
+      view_dist1(x, y) = math::Vec4f(0.0f);
+      view_dist2(x, y) = 0.0f;
+    }
+  }
+
+  return data;
+}
+
+static void RenderDense(render::ImageView<render::Color>& render_target, const DenseStarsData& data, float time) {
+  const auto extent     = render_target.Extent();
+  const auto view_dist1 = data.image_dist1.CreateView();
+  const auto view_dist2 = data.image_dist2.CreateView();
+
+  for (uint32_t y = 0U; y < extent.y; ++y) {
+    for (uint32_t x = 0U; x < extent.x; ++x) {
+      auto  dist1 = view_dist1(x, y);
+      float color = 0.0f;
+
+      if (dist1.w > 0.998f) {
+        color = 0.9f + 0.2f * math::FastSin(time + dist1.w);
+      } else if (dist1.x > 0.996f) {
+        float r = view_dist2(x, y);
+        color   = r * (0.25f * math::FastSin(time * (r * 5.0f) + 720.0f * r) + 0.75f);
+      }
+
+      render_target(x, y) = render::Color(math::Vec4f(color, color, color, 1.0f));
+    }
+  }
+}
+
+int main() {
+  const math::Vec2u extent(1024U, 768U);
+  const size_t      pixels = static_cast<size_t>(extent.x) * extent.y;
+
+  render::Image<render::Color> image(extent);
+  auto                         render_target = image.CreateView();
+
+  job::Executor executor;
+  const auto    stars_data = PrecalculateStarPositions(executor, extent);
+  executor.Stop();
+
+  const auto dense_data = MakeDenseStarsData(extent);
+
+  render::Renderer renderer;
+  renderer.BeginFrame(render_target);
+
+  float  time     = 0.0f;
+  double dense_ns = bench::MeasureNs(kIterations, [&]() {
+    RenderDense(render_target, dense_data, time += 0.016f);
+  });
+
+  double sparse_ns = bench::MeasureNs(kIterations, [&]() {
+    RenderBackground(renderer, render_target, stars_data, time += 0.016f);
+  });
+
+  /* 60 fps with the game's 20 Hz twinkle, so every third frame refreshes the layer. Nothing is drawn on top, so after
+   * the first frame only twinkling stars are damaged. */
+  auto   cache          = CreateBackgroundCache(stars_data, 20.0f);
+  size_t damaged_pixels = 0U;
+  double cached_ns      = bench::MeasureNs(kIterations, [&]() {
+    renderer.BeginFrame(render_target);
+    RenderBackground(cache, renderer, render_target, stars_data, time += 1.0f / 60.0f);
+    renderer.EndFrame();
+
+    damaged_pixels += renderer.FrameStats().damaged_pixels;
+  });
+
+  const size_t render_target_bytes = pixels * sizeof(render::Color);
+  const size_t dense_bytes         = pixels * (sizeof(math::Vec4f) + sizeof(float));
+  const size_t sparse_bytes = (stars_data.small_stars.size() + stars_data.big_stars.size()) * sizeof(Star);
+
+  std::printf("Star background, %ux%u, %zu small and %zu big stars\n", extent.x, extent.y,
+              stars_data.small_stars.size(), stars_data.big_stars.size());
+  std::printf("%-16s %14s %14s %14s\n", "representation", "data KB", "ms/frame", "GB/s");
+
+  /* Bandwidth counts the star data read plus the render target written */
+  std::printf("%-16s %14.1f %14.3f %14.2f\n", "dense", dense_bytes / 1024.0, dense_ns * 1e-6,
+              (dense_bytes + render_target_bytes) / dense_ns);
+  std::printf("%-16s %14.1f %14.3f %14.2f\n", "sparse", sparse_bytes / 1024.0, sparse_ns * 1e-6,
+              (sparse_bytes + render_target_bytes) / sparse_ns);
+  std::printf("%-16s %14.1f %14.3f %14s\n", "cached layer", (sparse_bytes + render_target_bytes) / 1024.0,
+              cached_ns * 1e-6, "-");
+
+  std::printf("\nCached layer damages %.1f%% of the frame on average\n",
+              100.0 * damaged_pixels / (kIterations + 1U) / pixels);
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Ecs.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Suite/Suite.hpp>
+
+#include <ECS/World.hpp>
+#include <Game/Components.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ra::bench {
+
+static constexpr uint32_t kEntitiesCount   = 10000U;
+static constexpr uint32_t kCollidersCount  = 1000U;
+static constexpr uint32_t kIterations      = 50U;
+static constexpr uint32_t kSetupIterations = 20U;
+
+static std::vector<ecs::EntityId> SpawnMovingEntities(ecs::World& world, uint32_t count) {
+  std::vector<ecs::EntityId> entities(count);
+
+  for (auto& entity : entities) {
+    entity = world.NewEntity();
+    world.Add<Transform>(entity);
+    world.Add<Velocity>(entity).velocity = math::Vec2f(1.0f, 2.0f);
+  }
+
+  return entities;
+}
+
+static void MoveSingle(float& dt, const Velocity& velocity, Transform& transform) {
+  transform.pos += velocity.velocity * dt;
+}
+
+static void MoveVector(float& dt, std::span<const Velocity> velocities, std::span<Transform> transforms) {
+  for (size_t i = 0U; i < velocities.size(); ++i) {
+    transforms[i].pos += velocities[i].velocity * dt;
+  }
+}
+
+static void CountCollisions(uint32_t& collisions, ecs::EntityId, ecs::EntityId) {
+  ++collisions;
+}
+
+/* Measures `operation` on a world freshly prepared by `setup` every iteration, only the operation is timed */
+template <typename Setup, typename Operation>
+static void RunWithSetup(Suite& suite, const std::string& name, uint32_t items, Setup&& setup, Operation&& operation) {
+  if (!suite.Enabled(name)) {
+    return;
+  }
+
+  double total_ns = 0.0;
+  for (uint32_t i = 0U; i < kSetupIterations; ++i) {
+    ecs::World world;
+    auto       entities = setup(world);
+
+    const auto start = Clock::now();
+    operation(world, entities);
+    total_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    DoNotOptimize(entities.data());
+  }
+
+  suite.Report(name, kSetupIterations, items, total_ns / kSetupIterations);
+}
+
+void RunEcsBenchmarks(Suite& suite) {
+  const auto suffix = "/" + std::to_string(kEntitiesCount);
+
+  RunWithSetup(suite, "World::NewEntity" + suffix, kEntitiesCount,
+    [](ecs::World&) { return std::vector<ecs::EntityId>(kEntitiesCount); },
+    [](ecs::World& world, std::vector<ecs::EntityId>& entities) {
+      for (auto& entity : entities) {
+        entity = world.NewEntity();
+      }
+    });
+
+  RunWithSetup(suite, "World::Add" + suffix, kEntitiesCount,
+    [](ecs::World& world) {
+      std::vector<ecs::EntityId> entities(kEntitiesCount);
+      for (auto& entity : entities) {
+        entity = world.NewEntity();
+        world.Add<Transform>(entity);
+      }
+      return entities;
+    },
+    [](ecs::World& world, std::vector<ecs::EntityId>& entities) {
+      for (auto entity : entities) {
+        world.Add<Velocity>(entity);
+      }
+    });
+
+  RunWithSetup(suite, "World::Remove" + suffix, kEntitiesCount,
+    [](ecs::World& world) { return SpawnMovingEntities(world, kEntitiesCount); },
+    [](ecs::World& world, std::vector<ecs::EntityId>& entities) {
+      for (auto entity : entities) {
+        world.Remove<Velocity>(entity);
+      }
+    });
+
+  RunWithSetup(suite, "World::DestroyEntity" + suffix, kEntitiesCount,
+    [](ecs::World& world) { return SpawnMovingEntities(world, kEntitiesCount); },
+    [](ecs::World& world, std::vector<ecs::EntityId>& entities) {
+      for (auto entity : entities) {
+        world.DestroyEntity(entity);
+      }
+    });
+
+  {
+    ecs::World world;
+    auto       entities = SpawnMovingEntities(world, kEntitiesCount);
+
+    /* Random order, as lookups of e.g. follow targets and collision pairs are */
+    std::shuffle(entities.begin(), entities.end(), std::mt19937(42U));
+
+    suite.Run("World::Get" + suffix, kIterations, kEntitiesCount, [&]() {
+      for (auto entity : entities) {
+        DoNotOptimize(world.Get<Transform>(entity).pos);
+      }
+    });
+
+    float dt = 1e-3f;
+    suite.Run("World::Run/single" + suffix, kIterations, kEntitiesCount, [&]() {
+      world.Run("MoveSingle", dt, &MoveSingle);
+    });
+
+    suite.Run("World::Run/vector" + suffix, kIterations, kEntitiesCount, [&]() {
+      world.Run("MoveVector", dt, &MoveVector);
+    });
+  }
+
+  {
+    ecs::World world;
+
+    std::mt19937                          random(42U);
+    std::uniform_real_distribution<float> random_pos(-100.0f, 100.0f);
+
+    for (uint32_t i = 0U; i < kCollidersCount; ++i) {
+      auto  entity   = world.NewEntity();
+      auto& collider = world.Add<SphereCollider>(entity);
+
+      collider.ws_pos    = math::Vec2f(random_pos(random), random_pos(random));
+      collider.ws_radius = 1.0f;
+    }
+
+    const double pairs      = 0.5 * kCollidersCount * (kCollidersCount - 1U);
+    uint32_t     collisions = 0U;
+
+    suite.Run("World::RunInteractions/" + std::to_string(kCollidersCount), 5U, pairs, [&]() {
+      world.RunInteractions<uint32_t, SphereCollider>("CountCollisions", collisions, &CountCollisions);
+    });
+
+    DoNotOptimize(collisions);
+  }
+
+  {
+    const std::string name = "ComponentArray::Insert" + suffix;
+
+    if (suite.Enabled(name)) {
+      const auto id = ecs::detail::ComponentTraits<Transform>::Id();
+
+      Transform       transform;
+      const std::span data(reinterpret_cast<const uint8_t*>(&transform), sizeof(transform));
+
+      suite.Run(name, kIterations, kEntitiesCount, [&]() {
+        ecs::detail::ComponentArray array(&ecs::detail::TypeErasedDestructor<Transform>, id, sizeof(Transform));
+        for (uint32_t i = 0U; i < kEntitiesCount; ++i) {
+          array.Insert(data);
+        }
+        DoNotOptimize(array.Data().data());
+      });
+    }
+  }
+}
+
+}  // namespace ra::bench
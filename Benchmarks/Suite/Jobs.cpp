@@ -0,0 +1,51 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Jobs.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Suite/Suite.hpp>
+
+#include <JobSystem/Executor.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace ra::bench {
+
+static constexpr uint32_t kJobsCount  = 10000U;
+static constexpr uint32_t kIterations = 20U;
+
+void RunJobBenchmarks(Suite& suite) {
+  const auto suffix = "/" + std::to_string(kJobsCount);
+
+  /* Submission and execution of trivial jobs, i.e. the per-job overhead of the executor */
+  std::vector<size_t> thread_counts = {1U};
+  if (const size_t hardware_threads = std::thread::hardware_concurrency(); hardware_threads > 1U) {
+    thread_counts.push_back(hardware_threads);
+  }
+
+  for (size_t threads : thread_counts) {
+    const auto name = "Executor::Submit/threads:" + std::to_string(threads) + suffix;
+    if (!suite.Enabled(name)) {
+      continue;
+    }
+
+    job::Executor         executor(threads);
+    std::atomic<uint32_t> counter{0U};
+
+    suite.Run(name, kIterations, kJobsCount, [&]() {
+      for (uint32_t i = 0U; i < kJobsCount; ++i) {
+        executor.Submit([&counter]() { counter.fetch_add(1U, std::memory_order_relaxed); });
+      }
+      executor.WaitIdle();
+    });
+
+    executor.Stop();
+  }
+}
+
+}  // namespace ra::bench
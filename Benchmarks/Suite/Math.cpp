@@ -0,0 +1,73 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Math.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Suite/Suite.hpp>
+
+#include <Math/Mat3.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ra::bench {
+
+static constexpr size_t   kMatricesCount = 4096U;
+static constexpr uint32_t kIterations    = 200U;
+
+void RunMathBenchmarks(Suite& suite) {
+  std::mt19937                          random(42U);
+  std::uniform_real_distribution<float> random_value(-10.0f, 10.0f);
+
+  std::vector<math::Mat3f> matrices(kMatricesCount);
+  std::vector<math::Vec3f> vectors(kMatricesCount);
+  std::vector<float>       angles(kMatricesCount);
+  std::vector<math::Mat3f> results(kMatricesCount);
+
+  for (size_t i = 0U; i < kMatricesCount; ++i) {
+    for (auto& element : matrices[i].elements) {
+      element = random_value(random);
+    }
+
+    vectors[i] = math::Vec3f(random_value(random), random_value(random), 1.0f);
+    angles[i]  = random_value(random);
+  }
+
+  suite.Run("Mat3*Mat3/" + std::to_string(kMatricesCount), kIterations, kMatricesCount, [&]() {
+    for (size_t i = 0U; i + 1U < kMatricesCount; ++i) {
+      results[i] = matrices[i] * matrices[i + 1U];
+    }
+    DoNotOptimize(results.data());
+  });
+
+  std::vector<math::Vec3f> transformed(kMatricesCount);
+  suite.Run("Mat3*Vec3/" + std::to_string(kMatricesCount), kIterations, kMatricesCount, [&]() {
+    for (size_t i = 0U; i < kMatricesCount; ++i) {
+      transformed[i] = matrices[i] * vectors[i];
+    }
+    DoNotOptimize(transformed.data());
+  });
+
+  suite.Run("Mat3::Transpose/" + std::to_string(kMatricesCount), kIterations, kMatricesCount, [&]() {
+    for (size_t i = 0U; i < kMatricesCount; ++i) {
+      results[i] = math::Transpose(matrices[i]);
+    }
+    DoNotOptimize(results.data());
+  });
+
+  /* Same composition as CalculateTransforms does for every entity */
+  suite.Run("Mat3/TranslationRotationScale/" + std::to_string(kMatricesCount), kIterations, kMatricesCount, [&]() {
+    for (size_t i = 0U; i < kMatricesCount; ++i) {
+      const auto pos = math::Vec2f(vectors[i].x, vectors[i].y);
+
+      results[i] = math::TranslationMatrix(pos) * (math::RotationMatrix(angles[i]) * math::ScaleMatrix(math::Vec2f(2.0f)));
+    }
+    DoNotOptimize(results.data());
+  });
+}
+
+}  // namespace ra::bench
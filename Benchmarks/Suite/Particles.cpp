@@ -0,0 +1,61 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Particles.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Suite/Suite.hpp>
+
+#include <JobSystem/Executor.hpp>
+#include <Render/ParticleSystem.hpp>
+
+#include <string>
+
+namespace ra::bench {
+
+static constexpr size_t   kParticlesCount = 100000U;
+static constexpr uint32_t kIterations     = 50U;
+
+void RunParticleBenchmarks(Suite& suite) {
+  const auto suffix = "/" + std::to_string(kParticlesCount);
+
+  const render::ParticleSystem::ParticleSpecs specs{
+    .origin             = math::Vec2f(0.0f),
+    .velocity           = math::Vec2f(1.0f, 2.0f),
+    .velocity_variation = math::Vec2f(1.0f),
+
+    .color_begin = math::Vec4f(0.9f, 0.8f, 0.1f, 1.0f),
+    .color_end   = math::Vec4f(1.0f, 0.4f, 0.1f, 0.0f),
+
+    .size_begin     = 0.05f,
+    .size_end       = 0.3f,
+    .size_variation = 0.05f,
+
+    /* Particles must outlive the benchmark, so that all of them are updated each iteration */
+    .lifetime = 1e6f
+  };
+
+  render::ParticleSystem system(kParticlesCount);
+  system.EmitBurst(specs, kParticlesCount);
+  system.Update(0.0f);  // Merges the burst
+
+  for (auto kernel : {render::ParticleKernel::Scalar, render::ParticleKernel::AVX2}) {
+    if (!render::IsSupported(kernel)) {
+      continue;
+    }
+
+    suite.Run("ParticleSystem::Update/" + std::string(render::ToString(kernel)) + suffix, kIterations, kParticlesCount,
+              [&]() { system.Update(1e-6f, kernel); });
+  }
+
+  job::Executor executor;
+  suite.Run("ParticleSystem::Update/jobs" + suffix, kIterations, kParticlesCount, [&]() {
+    system.Update(1e-6f, executor);
+    executor.WaitIdle();
+  });
+  executor.Stop();
+}
+
+}  // namespace ra::bench
@@ -0,0 +1,123 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Raster.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Suite/Suite.hpp>
+
+#include <Game/StarBackground.hpp>
+#include <JobSystem/Executor.hpp>
+#include <Render/Image.hpp>
+#include <Render/Renderer.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <string>
+
+namespace ra::bench {
+
+static constexpr math::Vec2u kExtent(1024U, 768U);
+static constexpr uint32_t    kLinesCount = 64U;
+static constexpr uint32_t    kIterations = 20U;
+static constexpr uint32_t    kShipsCount = 48U;
+static constexpr float       kShipSize   = 24.0f;  // Half of a ship's size in pixels
+
+/* Crosses of ship-sized lines spread over the render target, which is what a frame of the game draws over the
+ * background and the next one has to restore */
+static void DrawShips(render::Renderer& renderer) {
+  const auto transform = math::Identity<float>();
+  const auto color     = render::Color(90U, 200U, 255U, 255U);
+  const auto half_x    = math::Vec2f(kShipSize, 0.0f);
+  const auto half_y    = math::Vec2f(0.0f, kShipSize);
+
+  for (uint32_t i = 0U; i < kShipsCount; ++i) {
+    /* Golden ratio steps in x, so that ships don't line up */
+    const math::Vec2f pos((std::fmod(i * 0.618034f, 1.0f) - 0.5f) * kExtent.x,
+                          ((i + 0.5f) / kShipsCount - 0.5f) * kExtent.y);
+
+    renderer.CmdDrawLine(pos - half_x, pos + half_x, transform, color, 2.0f);
+    renderer.CmdDrawLine(pos - half_y, pos + half_y, transform, color, 2.0f);
+  }
+}
+
+void RunRasterBenchmarks(Suite& suite) {
+  render::Image<render::Color> image(kExtent);
+  auto                         render_target = image.CreateView();
+
+  /* World space is in pixels, centered on the render target */
+  render::Renderer renderer;
+  renderer.BeginFrame(render_target);
+  renderer.CmdSetViewInfo(math::OrthographicProjectionMatrix(kExtent.x, kExtent.y),
+                          math::InverseOrthographicProjectionMatrix(kExtent.x, kExtent.y));
+
+  /* Lines in all directions around the center, so that both steep and shallow ones are covered */
+  const auto transform = math::Identity<float>();
+  const auto color     = render::Color(200U, 120U, 40U, 255U);
+
+  for (float length : {8.0f, 64.0f, 512.0f}) {
+    for (float thickness : {1.0f, 2.0f, 4.0f}) {
+      char name[64];
+      std::snprintf(name, sizeof(name), "Renderer::CmdDrawLine/%.0f/%.0f", length, thickness);
+
+      suite.Run(name, kIterations, kLinesCount * length, [&]() {
+        for (uint32_t i = 0U; i < kLinesCount; ++i) {
+          const float angle = 2.0f * std::numbers::pi_v<float> * i / kLinesCount;
+          const auto  to    = 0.5f * length * math::Vec2f(std::cos(angle), std::sin(angle));
+
+          renderer.CmdDrawLine(-to, to, transform, color, thickness);
+        }
+      });
+    }
+  }
+
+  renderer.EndFrame();
+
+  /* Per-pixel background shading, the full pass and the cached layer the game uses */
+  const size_t pixels = static_cast<size_t>(kExtent.x) * kExtent.y;
+
+  job::Executor executor;
+  const auto    stars_data = PrecalculateStarPositions(executor, kExtent);
+  executor.Stop();
+
+  float time = 0.0f;
+  suite.Run("RenderBackground/full", kIterations, pixels, [&]() {
+    renderer.BeginFrame(render_target);
+    RenderBackground(renderer, render_target, stars_data, time += 1.0f / 60.0f);
+    renderer.EndFrame();
+  });
+
+  /* The cached background only restores what the previous frame drew over, so every frame draws ships. Only the
+   * background is timed and items are the restored pixels */
+  auto cache = CreateBackgroundCache(stars_data, 20.0f);
+  if (suite.Enabled("RenderBackground/cached")) {
+    renderer.BeginFrame(render_target);
+    DrawShips(renderer);
+    renderer.EndFrame();
+
+    double total_ns        = 0.0;
+    double restored_pixels = 0.0;
+
+    for (uint32_t i = 0U; i < kIterations; ++i) {
+      renderer.BeginFrame(render_target);
+
+      for (const auto& region : renderer.RestoreRegions()) {
+        restored_pixels += static_cast<double>(region.extent.x) * region.extent.y;
+      }
+
+      const auto start = Clock::now();
+      RenderBackground(cache, renderer, render_target, stars_data, time += 1.0f / 60.0f);
+      total_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+      DrawShips(renderer);
+      renderer.EndFrame();
+    }
+
+    suite.Report("RenderBackground/cached", kIterations, restored_pixels / kIterations, total_ns / kIterations);
+  }
+}
+
+}  // namespace ra::bench
@@ -0,0 +1,128 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Suite.cpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+//
+//  Usage: ra-benchmarks [--filter SUBSTRING] [--json PATH]
+//
+//  Runs the micro-benchmark suite, prints the results and writes them to PATH (benchmarks.json by default).
+//
+
+#include <Suite/Suite.hpp>
+
+#include <Utils/Log.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <thread>
+
+namespace ra::bench {
+
+Suite::Suite(std::string_view filter) : filter_(filter) {}
+
+bool Suite::Enabled(std::string_view name) const {
+  return filter_.empty() || name.find(filter_) != std::string_view::npos;
+}
+
+void Suite::Report(std::string_view name, uint32_t iterations, double items, double ns_per_iteration) {
+  const auto& result = results_.emplace_back(Result{.name                = std::string(name),
+                                                    .iterations          = iterations,
+                                                    .ns_per_iteration    = ns_per_iteration,
+                                                    .items_per_iteration = items});
+
+  std::printf("%-40s %14.1f %12.3f %14.3e\n", result.name.c_str(), result.ns_per_iteration,
+              result.ns_per_iteration / result.items_per_iteration,
+              result.items_per_iteration / result.ns_per_iteration * 1e9);
+}
+
+const std::vector<Suite::Result>& Suite::Results() const {
+  return results_;
+}
+
+bool Suite::WriteJson(const std::filesystem::path& filepath) const {
+  std::ofstream fs(filepath, std::ios::out);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  char date[32];
+  const auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  char line[256];
+  std::snprintf(line, sizeof(line), "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"num_cpus\": %u,\n", date,
+                std::thread::hardware_concurrency());
+  fs << line;
+
+#if defined(RA_DEBUG_MODE)
+  fs << "    \"library_build_type\": \"debug\"\n  },\n";
+#else
+  fs << "    \"library_build_type\": \"release\"\n  },\n";
+#endif
+
+  fs << "  \"benchmarks\": [\n";
+  for (size_t i = 0U; i < results_.size(); ++i) {
+    const auto& result = results_[i];
+
+    std::snprintf(line, sizeof(line),
+                  "    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %u, \"real_time\": %.3f, "
+                  "\"cpu_time\": %.3f, \"time_unit\": \"ns\", \"items_per_second\": %.6e}%s\n",
+                  result.name.c_str(), result.iterations, result.ns_per_iteration, result.ns_per_iteration,
+                  result.items_per_iteration / result.ns_per_iteration * 1e9, (i + 1U < results_.size()) ? "," : "");
+    fs << line;
+  }
+  fs << "  ]\n}\n";
+
+  if (!fs) {
+    RA_LOG_ERROR("Failed to write benchmark results \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  RA_LOG_INFO("Saved benchmark results \"%s\"", filepath.c_str());
+  return true;
+}
+
+}  // namespace ra::bench
+
+int main(int argc, const char** argv) {
+  std::string_view filter;
+  std::string_view json_path = "benchmarks.json";
+
+  for (int arg = 1; arg < argc; ++arg) {
+    const std::string_view name  = argv[arg];
+    const char*            value = (arg + 1 < argc) ? argv[arg + 1] : nullptr;
+
+    if (value == nullptr) {
+      RA_LOG_ERROR("Missing value of option \"%s\"", argv[arg]);
+      return 1;
+    }
+
+    if (name == "--filter") {
+      filter = value;
+    } else if (name == "--json") {
+      json_path = value;
+    } else {
+      RA_LOG_ERROR("Unknown option \"%s\"", argv[arg]);
+      return 1;
+    }
+
+    ++arg;
+  }
+
+  ra::bench::Suite suite(filter);
+
+  std::printf("%-40s %14s %12s %14s\n", "benchmark", "ns", "ns/item", "items/s");
+  ra::bench::RunEcsBenchmarks(suite);
+  ra::bench::RunMathBenchmarks(suite);
+  ra::bench::RunRasterBenchmarks(suite);
+  ra::bench::RunParticleBenchmarks(suite);
+  ra::bench::RunJobBenchmarks(suite);
+
+  return suite.WriteJson(json_path) ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Suite.hpp
+ * @date 2024-08-18
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <Benchmark.hpp>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ra::bench {
+
+/**
+ * Collection of micro-benchmark results, reported as a table and as JSON in Google Benchmark's format, so that its
+ * tools (e.g. compare.py) can be used on runs of different builds.
+ *
+ * Names follow Google Benchmark's "Subject/argument" convention, e.g. "World::Add/10000".
+ */
+class Suite {
+ public:
+  struct Result {
+    std::string name;
+    uint32_t    iterations{0U};
+    double      ns_per_iteration{0.0};
+    double      items_per_iteration{0.0};
+  };
+
+  /**
+   * Only benchmarks whose names contain `filter` are run, all of them if it's empty.
+   */
+  explicit Suite(std::string_view filter = {});
+
+  /**
+   * Whether benchmark `name` passes the filter, used to skip expensive setup of filtered out benchmarks.
+   */
+  [[nodiscard]] bool Enabled(std::string_view name) const;
+
+  /**
+   * Measures `func` with MeasureNs, `items` is the number of processed items (entities, pixels, jobs etc.) per call.
+   */
+  template <typename Func>
+  void Run(std::string_view name, uint32_t iterations, double items, Func&& func);
+
+  /**
+   * Records a result measured by the caller, for benchmarks which need untimed setup before every iteration.
+   */
+  void Report(std::string_view name, uint32_t iterations, double items, double ns_per_iteration);
+
+  [[nodiscard]] const std::vector<Result>& Results() const;
+
+  bool WriteJson(const std::filesystem::path& filepath) const;
+
+ private:
+  std::string         filter_;
+  std::vector<Result> results_;
+};
+
+template <typename Func>
+void Suite::Run(std::string_view name, uint32_t iterations, double items, Func&& func) {
+  if (!Enabled(name)) {
+    return;
+  }
+
+  Report(name, iterations, items, MeasureNs(iterations, std::forward<Func>(func)));
+}
+
+/* Benchmarks of every subsystem, see Suite/<Subsystem>.cpp */
+void RunEcsBenchmarks(Suite& suite);
+void RunMathBenchmarks(Suite& suite);
+void RunRasterBenchmarks(Suite& suite);
+void RunParticleBenchmarks(Suite& suite);
+void RunJobBenchmarks(Suite& suite);
+
+}  // namespace ra::bench
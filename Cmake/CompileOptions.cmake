@@ -95,6 +95,43 @@ if(RA_ENABLE_COLOR_LOG_OUTPUT)
   add_ra_compile_flags("-DRA_ENABLE_COLOR_LOG_OUTPUT")
 endif()
 
+option(RA_ENABLE_PROFILING "Record RA_PROFILE_SCOPE timings and report them every second" OFF)
+
+if(RA_ENABLE_PROFILING)
+  message("-- Profiling enabled")
+  add_ra_compile_flags("-DRA_ENABLE_PROFILING")
+endif()
+
+option(RA_ENABLE_PERF_COUNTERS "Read hardware counters in every RA_PROFILE_SCOPE (Linux only, implies RA_ENABLE_PROFILING)" OFF)
+
+if(RA_ENABLE_PERF_COUNTERS)
+  if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    message("-- Hardware performance counters enabled")
+    add_ra_compile_flags("-DRA_ENABLE_PERF_COUNTERS")
+
+    if(NOT RA_ENABLE_PROFILING)
+      message("-- Profiling enabled")
+      add_ra_compile_flags("-DRA_ENABLE_PROFILING")
+    endif()
+  else()
+    message(WARNING "Hardware performance counters are only supported on Linux")
+  endif()
+endif()
+
+option(RA_TRACK_ALLOCATIONS "Replace global operator new/delete to count allocations and capture their call sites" OFF)
+
+if(RA_TRACK_ALLOCATIONS)
+  if(RA_BUILD_WITH_ASAN OR RA_BUILD_WITH_TSAN)
+    message(FATAL_ERROR "Allocation tracking can not be enabled together with sanitizers, which replace operator new")
+  endif()
+
+  message("-- Allocation tracking enabled")
+  add_ra_compile_flags("-DRA_TRACK_ALLOCATIONS")
+
+  # Exports symbols of executables, so that backtraces of call sites can be symbolized
+  add_ra_link_flags("-rdynamic")
+endif()
+
 # Convert to have ; as separators
 string(REPLACE " " ";" RA_COMPILE_FLAGS "${RA_COMPILE_FLAGS}")
 string(REPLACE " " ";" RA_LINK_FLAGS "${RA_LINK_FLAGS}")
@@ -9,6 +9,7 @@
 #include <Asset/FontAtlas.hpp>
 
 #include <Asset/ImageLoader.hpp>
+#include <Render/BlendKernels.hpp>
 
 #include <fstream>
 
@@ -58,7 +59,13 @@ static void ParseCommon(std::string_view view, FontAtlas& font) {
 }
 
 static void ParseChar(std::string_view view, FontAtlas& font) {
-  char ch = ParseTokenInt<"id">(view);
+  const int32_t id = ParseTokenInt<"id">(view);
+  if (id < 0 || id >= static_cast<int32_t>(FontAtlas::kCharactersCount)) {
+    RA_LOG_WARN("Skipping character %d, only single byte characters are supported", id);
+    return;
+  }
+
+  const auto ch = static_cast<uint8_t>(id);
 
   FontAtlas::CharacterInfo info;
   info.position_in_image.x = ParseTokenInt<"x">(view);
@@ -88,6 +95,12 @@ std::shared_ptr<FontAtlas> LoadFontAtlas_BMFontAtlas(const std::filesystem::path
     return nullptr;
   }
 
+  /* Renderer blends premultiplied colors only */
+  auto pixels = image->CreateView().Data();
+  for (auto& pixel : pixels) {
+    pixel = render::PremultiplyAlpha(pixel);
+  }
+
   auto font   = std::make_shared<FontAtlas>();
   font->image = image;
 
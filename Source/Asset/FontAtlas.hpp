@@ -11,24 +11,27 @@
 #include <Render/Color.hpp>
 #include <Render/Image.hpp>
 
+#include <array>
 #include <filesystem>
-#include <unordered_map>
 
 namespace ra::asset {
 
 struct FontAtlas {
   struct CharacterInfo {
-    math::Vec2i position_in_image;
-    math::Vec2i extent_pixels;
-    math::Vec2i offset;
-    int32_t     advance;
+    math::Vec2i position_in_image{0};
+    math::Vec2i extent_pixels{0};
+    math::Vec2i offset{0};
+    int32_t     advance{0};
   };
 
+  static constexpr size_t kCharactersCount = 256U;
+
+  /* Flat tables indexed by the character's byte value, characters missing from the font are empty */
   using Image            = ::ra::render::Image<render::Color>;
-  using CharacterInfoMap = std::unordered_map<char, CharacterInfo>;
-  using ImageViewMap     = std::unordered_map<char, render::ImageView<render::Color>>;
+  using CharacterInfoMap = std::array<CharacterInfo, kCharactersCount>;
+  using ImageViewMap     = std::array<render::ImageView<render::Color>, kCharactersCount>;
 
-  std::shared_ptr<Image> image;
+  std::shared_ptr<Image> image;  // Premultiplied alpha
   ImageViewMap           image_views;
   CharacterInfoMap       characters;
 
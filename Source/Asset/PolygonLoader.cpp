@@ -64,6 +64,8 @@ std::shared_ptr<render::Polygon> LoadPolygon(const std::filesystem::path& filepa
     }
   }
 
+  polygon->ms_bounds = render::CalculateBounds(*polygon);
+
   return polygon;
 }
 
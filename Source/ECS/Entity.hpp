@@ -10,12 +10,30 @@
 
 #include <Utils/TypeSafeId.hpp>
 
+#include <cstdint>
+
 namespace ra::ecs {
 
 namespace detail {
 class EntityTag;
 }  // namespace detail
 
+/**
+ * Index of the entity's slot in the world's registry in the low 32 bits and the slot's generation in the high 32 bits.
+ * Slots of destroyed entities are reused with the next generation, so stale ids never alias a new entity.
+ */
 using EntityId = utils::TypeSafeId<detail::EntityTag>;
 
+[[nodiscard]] constexpr EntityId MakeEntityId(uint32_t index, uint32_t generation) {
+  return EntityId((static_cast<uint64_t>(generation) << 32U) | index);
+}
+
+[[nodiscard]] constexpr uint32_t EntityIndex(EntityId entity) {
+  return static_cast<uint32_t>(entity.Value());
+}
+
+[[nodiscard]] constexpr uint32_t EntityGeneration(EntityId entity) {
+  return static_cast<uint32_t>(entity.Value() >> 32U);
+}
+
 }  // namespace ra::ecs
@@ -11,7 +11,7 @@
 #include <ECS/Entity.hpp>
 
 #include <span>
-#include <unordered_map>
+#include <vector>
 
 namespace ra::ecs {
 
@@ -25,7 +25,7 @@ template <typename Context, typename... Components>
 using SystemVector = void(*)(Context& context, std::span<Components>...);
 
 template <typename Context, typename... Components>
-using MegaSystemVector = void (*)(Context& context, const std::unordered_map<uint64_t, EntityId>& idx_to_entity,
+using MegaSystemVector = void (*)(Context& context, const std::vector<EntityId>& idx_to_entity,
                                   std::span<Components>...);
 
 template <typename Context, typename... Components>
@@ -8,6 +8,10 @@
 
 #include <ECS/World.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+
 namespace ra::ecs {
 
 static const auto kNullComponentMask = detail::ComponentMask(0U);
@@ -16,24 +20,58 @@ World::World() {
   auto null_archetype = std::make_unique<Archetype>();
   null_archetype->component_mask = kNullComponentMask;
   archetype_registry_[kNullComponentMask] = std::move(null_archetype);
+
+  entity_registry_.reserve(kReservedEntities);
+  free_entities_.reserve(kReservedEntities);
 }
 
 EntityId World::NewEntity() {
-  const auto entity_id = EntityId(next_entity_id_++);
+  auto* null_archetype = archetype_registry_.at(kNullComponentMask).get();
+
+  if (!free_entities_.empty()) {
+    const uint32_t index = free_entities_.back();
+    free_entities_.pop_back();
+
+    auto& record     = entity_registry_[index];
+    record.archetype = null_archetype;
+    record.idx       = 0U;
+
+    return MakeEntityId(index, record.generation);
+  }
 
-  entity_registry_[entity_id] = {
-    .archetype = archetype_registry_.at(kNullComponentMask).get(),
-    .idx       = 0U
-  };
+  const auto index = static_cast<uint32_t>(entity_registry_.size());
+  entity_registry_.push_back({.archetype = null_archetype, .idx = 0U, .generation = 0U});
 
-  return entity_id;
+  return MakeEntityId(index, 0U);
 }
 
 void World::DestroyEntity(EntityId entity) {
-  if (auto it = entity_registry_.find(entity); it != entity_registry_.end()) {
-    RemoveEntityRecord(it->second, true);
-    entity_registry_.erase(it);
+  if (FindRecord(entity) == nullptr) {
+    return;
   }
+
+  auto& record = entity_registry_[EntityIndex(entity)];
+  RemoveEntityRecord(record, true);
+
+  /* Ids of the destroyed entity no longer match the slot */
+  record.archetype = nullptr;
+  ++record.generation;
+
+  free_entities_.push_back(EntityIndex(entity));
+}
+
+const World::EntityRecord* World::FindRecord(EntityId entity) const {
+  const uint32_t index = EntityIndex(entity);
+  if (index >= entity_registry_.size()) {
+    return nullptr;
+  }
+
+  const auto& record = entity_registry_[index];
+  if (record.archetype == nullptr || record.generation != EntityGeneration(entity)) {
+    return nullptr;
+  }
+
+  return &record;
 }
 
 World::Archetype* World::FindArchetype(detail::ComponentMask component_mask) {
@@ -89,11 +127,105 @@ void World::RemoveEntityRecord(EntityRecord record, bool destroy_component) {
   const auto last_entity = archetype.idx_to_entity[last_idx];
 
   if (record.idx != last_idx) {
-    archetype.idx_to_entity[record.idx] = last_entity;
-    entity_registry_[last_entity].idx   = record.idx;
+    archetype.idx_to_entity[record.idx]       = last_entity;
+    entity_registry_[EntityIndex(last_entity)].idx = record.idx;
+  }
+
+  archetype.idx_to_entity.pop_back();
+}
+
+/* Registries' live entries, i.e. their nodes without the bucket arrays */
+template <typename Map>
+static profile::MemoryEntry MapEntry(const char* name, const Map& map) {
+  const size_t reserved = profile::HashMapBytes(map);
+
+  return {.category       = "registry",
+          .name           = name,
+          .count          = map.size(),
+          .capacity       = map.bucket_count(),
+          .used_bytes     = reserved - map.bucket_count() * sizeof(void*),
+          .reserved_bytes = reserved};
+}
+
+void World::ReportMemory(profile::MemoryReport& report) const {
+  std::array<profile::MemoryEntry, detail::SequentialGenerator::kMaxComponents> components;
+  std::vector<profile::MemoryEntry>                                            archetypes;
+
+  profile::MemoryEntry idx_to_entity{.category = "registry", .name = "idx_to_entity (all archetypes)"};
+  profile::MemoryEntry archetype_registry = MapEntry("archetypes", archetype_registry_);
+  archetype_registry.used_bytes     += archetype_registry_.size() * sizeof(Archetype);
+  archetype_registry.reserved_bytes += archetype_registry_.size() * sizeof(Archetype);
+
+  for (const auto& [mask, archetype] : archetype_registry_) {
+    archetype_registry.used_bytes     += archetype->component_arrays.size() * sizeof(detail::ComponentArray);
+    archetype_registry.reserved_bytes += archetype->component_arrays.capacity() * sizeof(detail::ComponentArray);
+
+    idx_to_entity.count          += archetype->idx_to_entity.size();
+    idx_to_entity.capacity       += archetype->idx_to_entity.capacity();
+    idx_to_entity.used_bytes     += archetype->idx_to_entity.size() * sizeof(EntityId);
+    idx_to_entity.reserved_bytes += profile::VectorBytes(archetype->idx_to_entity);
+
+    if (archetype->component_arrays.empty()) {
+      continue;
+    }
+
+    /* All arrays of an archetype have the same number of rows */
+    auto& entry    = archetypes.emplace_back();
+    entry.category = "archetype";
+    entry.name     = "[";
+    entry.count    = archetype->component_arrays.front().Size();
+    entry.capacity = archetype->component_arrays.front().Capacity();
+
+    for (const auto& array : archetype->component_arrays) {
+      const size_t used     = array.Size() * array.ComponentSize();
+      const size_t reserved = array.Capacity() * array.ComponentSize();
+
+      entry.name += std::string(detail::SequentialGenerator::Name(array.ComponentId()));
+      entry.name += (&array != &archetype->component_arrays.back()) ? ", " : "]";
+      entry.used_bytes     += used;
+      entry.reserved_bytes += reserved;
+
+      auto& component = components[std::countr_zero(array.ComponentId().Value()) % components.size()];
+      component.name            = detail::SequentialGenerator::Name(array.ComponentId());
+      component.count          += array.Size();
+      component.capacity       += array.Capacity();
+      component.used_bytes     += used;
+      component.reserved_bytes += reserved;
+    }
+  }
+
+  for (auto& component : components) {
+    if (!component.name.empty()) {
+      component.category = "component";
+      report.Add(std::move(component));
+    }
+  }
+
+  std::sort(archetypes.begin(), archetypes.end(), [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+  for (auto& archetype : archetypes) {
+    report.Add(std::move(archetype));
+  }
+
+  profile::MemoryEntry component_registry = MapEntry("components", component_registry_);
+  for (const auto& [id, records] : component_registry_) {
+    const auto map = MapEntry("", records);
+    component_registry.used_bytes     += map.used_bytes;
+    component_registry.reserved_bytes += map.reserved_bytes;
   }
 
-  archetype.idx_to_entity.erase(last_idx);
+  /* Free slots are accounted with the registry */
+  const size_t live_entities = std::count_if(entity_registry_.begin(), entity_registry_.end(),
+                                             [](const auto& record) { return record.archetype != nullptr; });
+  report.Add({.category       = "registry",
+              .name           = "entities",
+              .count          = live_entities,
+              .capacity       = entity_registry_.capacity(),
+              .used_bytes     = entity_registry_.size() * sizeof(EntityRecord) +
+                                free_entities_.size() * sizeof(FreeEntities::value_type),
+              .reserved_bytes = profile::VectorBytes(entity_registry_) + profile::VectorBytes(free_entities_)});
+  report.Add(std::move(archetype_registry));
+  report.Add(std::move(component_registry));
+  report.Add(std::move(idx_to_entity));
 }
 
 }  // namespace ra::ecs
\ No newline at end of file
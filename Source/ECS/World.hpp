@@ -12,6 +12,8 @@
 #include <ECS/System.hpp>
 #include <ECS/detail/Component.hpp>
 #include <ECS/detail/ComponentArray.hpp>
+#include <Profile/MemoryReport.hpp>
+#include <Profile/Profiler.hpp>
 
 #include <memory>
 #include <unordered_map>
@@ -68,7 +70,8 @@ namespace ra::ecs {
  * ------------------------------------
  *
  * Entity world is simply speaking just a map from `EntityId` to `pair<Archetype, std::size_t>`, where the
- * latter is the actual index into the archetype's multi-array.
+ * latter is the actual index into the archetype's multi-array. The map is a vector indexed by the id's slot, slots of
+ * destroyed entities are recycled with a new generation (see EntityId).
  */
 class World {
  public:
@@ -92,39 +95,54 @@ class World {
   template <typename Component>
   void Remove(EntityId entity);
 
+  /**
+   * Systems are run over every archetype having all of their components. `name` is the system's profile scope, it must
+   * be a string literal (see RA_PROFILE_SCOPE).
+   */
   template <typename... Components>
-  void Run(FreeSystem<Components...> system);
+  void Run(const char* name, FreeSystem<Components...> system);
 
   template <typename Context, typename... Components>
-  void Run(Context& context, SystemSingle<Context, Components...> system);
+  void Run(const char* name, Context& context, SystemSingle<Context, Components...> system);
 
   template <typename Context, typename... Components>
-  void Run(Context& context, SystemVector<Context, Components...> system);
+  void Run(const char* name, Context& context, SystemVector<Context, Components...> system);
 
   template <typename Context, typename... Components>
-  void Run(Context& context, MegaSystemVector<Context, Components...> system);
+  void Run(const char* name, Context& context, MegaSystemVector<Context, Components...> system);
 
   template <typename Context, typename... Components>
-  void RunInteractions(Context& context, InteractionSystem<Context, Components...> system);
+  void RunInteractions(const char* name, Context& context, InteractionSystem<Context, Components...> system);
+
+  /**
+   * Adds component storage per component type and per archetype (live rows vs capacity), as well as the registries.
+   */
+  void ReportMemory(profile::MemoryReport& report) const;
 
  private:
   struct Archetype {
     using ComponentArrays = std::vector<detail::ComponentArray>;
-    using MapIdxToEntity  = std::unordered_map<uint64_t, EntityId>;
+    using IdxToEntity     = std::vector<EntityId>;  // Entity of every row, rows are dense so it's only appended to
 
     detail::ComponentMask component_mask;
     ComponentArrays       component_arrays;
-    MapIdxToEntity        idx_to_entity;
+    IdxToEntity           idx_to_entity;
   };
 
   struct EntityRecord {
     Archetype* archetype;
     uint64_t   idx;
+    uint32_t   generation{0U};
   };
 
   using ArchetypeRegistry = std::unordered_map<detail::ComponentMask, std::unique_ptr<Archetype>>;
 
-  using EntityRegistry = std::unordered_map<EntityId, EntityRecord>;
+  /* Indexed by entity slot, destroyed entities have a null archetype and their slots are on the free list */
+  using EntityRegistry = std::vector<EntityRecord>;
+  using FreeEntities   = std::vector<uint32_t>;
+
+  /* Live entities before the registry first grows. Slots are recycled, so it only grows with the peak population */
+  static constexpr size_t kReservedEntities = 4096U;
 
   using ComponentRecords  = std::unordered_map<Archetype*, uint64_t>;
   using ComponentRegistry = std::unordered_map<detail::ComponentId, ComponentRecords>;
@@ -135,28 +153,34 @@ class World {
 
   void RemoveEntityRecord(EntityRecord record, bool destroy_component);
 
+  /* @return Record of a live entity, null if it has been destroyed (the slot's generation has moved on) */
+  [[nodiscard]] const EntityRecord* FindRecord(EntityId entity) const;
+
   template <typename Component>
   std::span<Component> QueryComponent(Archetype& archetype);
 
   template <typename Context, typename... Components>
   void RunInteractionsInternal(Context& context, InteractionSystem<Context, Components...>, EntityId first_entity,
-                               ArchetypeRegistry::const_iterator         it_archetypes,
-                               Archetype::MapIdxToEntity::const_iterator it_entity_mappings);
+                               ArchetypeRegistry::const_iterator      it_archetypes,
+                               Archetype::IdxToEntity::const_iterator it_entity_mappings);
 
   ArchetypeRegistry archetype_registry_;
   EntityRegistry    entity_registry_;
+  FreeEntities      free_entities_;
   ComponentRegistry component_registry_;
-  uint64_t          next_entity_id_{0U};
 };
 
 template <typename Component>
 bool World::Has(EntityId entity) const {
   static const detail::ComponentId kComponentId = detail::ComponentTraits<Component>::Id();
 
-  auto*       archetype         = entity_registry_.at(entity).archetype;
-  const auto& component_records = component_registry_.at(kComponentId);
+  const auto* entity_record = FindRecord(entity);
+  if (entity_record == nullptr) {
+    return false;
+  }
 
-  return component_records.contains(archetype);
+  const auto& component_records = component_registry_.at(kComponentId);
+  return component_records.contains(entity_record->archetype);
 }
 
 template <typename Component>
@@ -168,8 +192,13 @@ template <typename Component>
 Component* World::TryGet(EntityId entity) {
   static const detail::ComponentId kComponentId = detail::ComponentTraits<Component>::Id();
 
-  auto  entity_record = entity_registry_[entity];
-  auto* archetype     = entity_record.archetype;
+  /* Destroyed entities don't have any components */
+  const auto* entity_record = FindRecord(entity);
+  if (entity_record == nullptr) {
+    return nullptr;
+  }
+
+  auto* archetype = entity_record->archetype;
 
   auto& component_records   = component_registry_.at(kComponentId);
   auto  component_record_it = component_records.find(archetype);
@@ -178,14 +207,14 @@ Component* World::TryGet(EntityId entity) {
   }
 
   auto component_record = component_record_it->second;
-  return &archetype->component_arrays[component_record].template At<Component>(entity_record.idx);
+  return &archetype->component_arrays[component_record].template At<Component>(entity_record->idx);
 }
 
 template <typename Component, typename... ArgTypes>
 Component& World::Add(EntityId entity, ArgTypes&&... args) {
   static const detail::ComponentId kComponentId = detail::ComponentTraits<Component>::Id();
 
-  auto  old_record    = entity_registry_[entity];
+  auto  old_record    = entity_registry_[EntityIndex(entity)];
   auto* old_archetype = old_record.archetype;
 
   auto  new_component_mask = old_archetype->component_mask | detail::ComponentMask(kComponentId.Value());
@@ -206,8 +235,9 @@ Component& World::Add(EntityId entity, ArgTypes&&... args) {
   // Add new component to new archetype's record
   auto comp_idx   = component_registry_.at(kComponentId).at(new_archetype);
   auto entity_idx = new_archetype->component_arrays[comp_idx].Emplace<Component>(std::forward<ArgTypes>(args)...);
-  new_archetype->idx_to_entity[entity_idx] = entity;
-  entity_registry_[entity] = EntityRecord{.archetype = new_archetype, .idx = entity_idx};
+  new_archetype->idx_to_entity.push_back(entity);
+  entity_registry_[EntityIndex(entity)] =
+      EntityRecord{.archetype = new_archetype, .idx = entity_idx, .generation = old_record.generation};
 
   // Remove entity record from old archetype
   RemoveEntityRecord(old_record, false);
@@ -219,16 +249,20 @@ template <typename Component>
 void World::Remove(EntityId entity) {
   static const detail::ComponentId kComponentId = detail::ComponentTraits<Component>::Id();
 
-  auto  old_record    = entity_registry_[entity];
+  auto  old_record    = entity_registry_[EntityIndex(entity)];
   auto* old_archetype = old_record.archetype;
 
   auto  new_component_mask = old_archetype->component_mask.Without(detail::ComponentMask(kComponentId.Value()));
   auto* new_archetype      = FindArchetype(new_component_mask);
   if (!new_archetype) {
-    new_archetype = CreateArchetype(&detail::TypeErasedDestructor<Component>, old_archetype,
-                                    new_component_mask, sizeof(Component));
+    new_archetype = CreateArchetype(old_archetype, new_component_mask, sizeof(Component),
+                                    &detail::TypeErasedDestructor<Component>);
   }
 
+  // Destroy the removed component, the rest are moved to the new archetype's record
+  auto removed_idx = component_registry_.at(kComponentId).at(old_archetype);
+  old_archetype->component_arrays[removed_idx].template At<Component>(old_record.idx).~Component();
+
   // Move all overlapping components from old archetype's record to new one
   uint64_t entity_idx = 0U;
   for (auto& new_array : new_archetype->component_arrays) {
@@ -238,15 +272,20 @@ void World::Remove(EntityId entity) {
     entity_idx = new_array.Insert(old_archetype->component_arrays[comp_idx].At(old_record.idx));
   }
 
-  new_archetype->idx_to_entity[entity_idx] = entity;
-  entity_registry_[entity] = EntityRecord{.archetype = new_archetype, .idx = entity_idx};
+  if (!new_archetype->component_arrays.empty()) {
+    new_archetype->idx_to_entity.push_back(entity);
+  }
+  entity_registry_[EntityIndex(entity)] =
+      EntityRecord{.archetype = new_archetype, .idx = entity_idx, .generation = old_record.generation};
 
   // Remove entity record from old archetype
-  RemoveEntityRecord(old_record, true);
+  RemoveEntityRecord(old_record, false);
 }
 
 template <typename... Components>
-void World::Run(FreeSystem<Components...> system) {
+void World::Run([[maybe_unused]] const char* name, FreeSystem<Components...> system) {
+  RA_PROFILE_SCOPE(name);
+
   static const detail::ComponentMask kComponentMask = detail::ComponentMaskOf<std::remove_cv_t<Components>...>();
 
   for (const auto& [archetype_mask, archetype] : archetype_registry_) {
@@ -257,7 +296,7 @@ void World::Run(FreeSystem<Components...> system) {
 }
 
 template <typename Context, typename... Components>
-void World::Run(Context& context, SystemSingle<Context, Components...> system) {
+void World::Run([[maybe_unused]] const char* name, Context& context, SystemSingle<Context, Components...> system) {
   struct ExtendedContext {
     SystemSingle<Context, Components...>& single_system;
     Context&                              single_context;
@@ -266,11 +305,13 @@ void World::Run(Context& context, SystemSingle<Context, Components...> system) {
     .single_context = context
   };
 
-  Run(extended_context, &detail::DefaultVectorSystem<ExtendedContext, Components...>);
+  Run(name, extended_context, &detail::DefaultVectorSystem<ExtendedContext, Components...>);
 }
 
 template <typename Context, typename... Components>
-void World::Run(Context& context, SystemVector<Context, Components...> system) {
+void World::Run([[maybe_unused]] const char* name, Context& context, SystemVector<Context, Components...> system) {
+  RA_PROFILE_SCOPE(name);
+
   static const detail::ComponentMask kComponentMask = detail::ComponentMaskOf<std::remove_cv_t<Components>...>();
 
   for (const auto& [archetype_mask, archetype] : archetype_registry_) {
@@ -281,7 +322,9 @@ void World::Run(Context& context, SystemVector<Context, Components...> system) {
 }
 
 template <typename Context, typename... Components>
-void World::Run(Context& context, MegaSystemVector<Context, Components...> system) {
+void World::Run([[maybe_unused]] const char* name, Context& context, MegaSystemVector<Context, Components...> system) {
+  RA_PROFILE_SCOPE(name);
+
   static const detail::ComponentMask kComponentMask = detail::ComponentMaskOf<std::remove_cv_t<Components>...>();
 
   for (const auto& [archetype_mask, archetype] : archetype_registry_) {
@@ -292,7 +335,10 @@ void World::Run(Context& context, MegaSystemVector<Context, Components...> syste
 }
 
 template <typename Context, typename... Components>
-void World::RunInteractions(Context& context, InteractionSystem<Context, Components...> system) {
+void World::RunInteractions([[maybe_unused]] const char* name, Context& context,
+                            InteractionSystem<Context, Components...> system) {
+  RA_PROFILE_SCOPE(name);
+
   static const detail::ComponentMask kComponentMask = detail::ComponentMaskOf<std::remove_cv_t<Components>...>();
 
   for (auto archetype_it = archetype_registry_.begin(); archetype_it != archetype_registry_.end(); ++archetype_it) {
@@ -303,7 +349,7 @@ void World::RunInteractions(Context& context, InteractionSystem<Context, Compone
 
     auto& idx_to_entity = archetype->idx_to_entity;
     for (auto it_entity = idx_to_entity.begin(); it_entity != idx_to_entity.end(); ++it_entity) {
-      RunInteractionsInternal<Context, Components...>(context, system, it_entity->second, archetype_it, it_entity);
+      RunInteractionsInternal<Context, Components...>(context, system, *it_entity, archetype_it, it_entity);
     }
   }
 }
@@ -311,7 +357,7 @@ void World::RunInteractions(Context& context, InteractionSystem<Context, Compone
 template <typename Context, typename... Components>
 void World::RunInteractionsInternal(Context& context, InteractionSystem<Context, Components...> system,
                                     EntityId first_entity, ArchetypeRegistry::const_iterator it_archetypes,
-                                    Archetype::MapIdxToEntity::const_iterator it_entity_mappings) {
+                                    Archetype::IdxToEntity::const_iterator it_entity_mappings) {
   static const detail::ComponentMask kComponentMask = detail::ComponentMaskOf<std::remove_cv_t<Components>...>();
 
   for (auto archetype_it = it_archetypes; archetype_it != archetype_registry_.end(); ++archetype_it) {
@@ -323,8 +369,8 @@ void World::RunInteractionsInternal(Context& context, InteractionSystem<Context,
     auto& idx_to_entity = archetype->idx_to_entity;
     auto  it_entity     = (archetype_it == it_archetypes) ? it_entity_mappings : idx_to_entity.begin();
     for (; it_entity != idx_to_entity.end(); ++it_entity) {
-      if (first_entity != it_entity->second) {
-        system(context, first_entity, it_entity->second);
+      if (first_entity != *it_entity) {
+        system(context, first_entity, *it_entity);
       }
     }
   }
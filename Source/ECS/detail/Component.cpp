@@ -8,12 +8,23 @@
 
 #include <ECS/detail/Component.hpp>
 
+#include <bit>
+
 namespace ra::ecs::detail {
 
-uint64_t SequentialGenerator::current_{0U};
+uint64_t                                                          SequentialGenerator::current_{0U};
+std::array<std::string_view, SequentialGenerator::kMaxComponents> SequentialGenerator::names_{};
+
+uint64_t SequentialGenerator::Next(std::string_view name) {
+  if (current_ < kMaxComponents) {
+    names_[current_] = name;
+  }
 
-uint64_t SequentialGenerator::Next() {
   return current_++;
 }
 
+std::string_view SequentialGenerator::Name(ComponentId id) {
+  return names_[std::countr_zero(id.Value()) % kMaxComponents];
+}
+
 }  // namespace ra::ecs::detail
\ No newline at end of file
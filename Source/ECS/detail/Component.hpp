@@ -9,9 +9,13 @@
 #pragma once
 
 #include <Utils/Assert.hpp>
+#include <Utils/TypeName.hpp>
 #include <Utils/TypeSafeBitmask.hpp>
 #include <Utils/TypeSafeId.hpp>
 
+#include <array>
+#include <string_view>
+
 namespace ra::ecs::detail {
 
 /* Id */
@@ -20,10 +24,16 @@ using ComponentId = ra::utils::TypeSafeId<ComponentTag>;
 
 class SequentialGenerator {
  public:
-  static uint64_t Next();
+  static constexpr uint64_t kMaxComponents = 64U;
+
+  /* Returns the next bit index, `name` is kept for reports */
+  static uint64_t Next(std::string_view name);
+
+  [[nodiscard]] static std::string_view Name(ComponentId id);
 
  private:
-  static uint64_t current_;
+  static uint64_t                                     current_;
+  static std::array<std::string_view, kMaxComponents> names_;
 };
 
 template <typename Component>
@@ -42,7 +52,7 @@ constexpr ComponentId ComponentTraits<Component>::Id() {
 }
 
 template <typename Component>
-uint64_t ComponentTraits<Component>::bit_index_{SequentialGenerator::Next()};
+uint64_t ComponentTraits<Component>::bit_index_{SequentialGenerator::Next(utils::TypeName<Component>())};
 
 /* Mask */
 using ComponentMask = ra::utils::TypeSafeBitmask<ComponentTag>;
@@ -84,6 +84,8 @@ ComponentArray::DestructorFunc ComponentArray::Destructor() const {
 
 size_t ComponentArray::Size() const { return size_; }
 
+size_t ComponentArray::Capacity() const { return capacity_; }
+
 detail::ComponentId ComponentArray::ComponentId() const {
   return component_id_;
 }
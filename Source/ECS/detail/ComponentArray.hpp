@@ -45,6 +45,7 @@ class ComponentArray {
 
   [[nodiscard]] DestructorFunc Destructor() const;
   [[nodiscard]] size_t Size() const;
+  [[nodiscard]] size_t Capacity() const;
   [[nodiscard]] detail::ComponentId ComponentId() const;
   [[nodiscard]] size_t ComponentSize() const;
 
@@ -76,6 +76,11 @@ struct Damage {
   int32_t value;
 };
 
+/* Stationary source of particles, emits a burst of `burst_size` particles every frame */
+struct ParticleEmitter {
+  uint32_t burst_size{64U};
+};
+
 /* Render components */
 struct PolygonRenderer {
   std::shared_ptr<render::Polygon> polygon;
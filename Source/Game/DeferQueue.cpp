@@ -10,6 +10,10 @@
 
 namespace ra {
 
+DeferQueue::DeferQueue() {
+  tasks_.reserve(kReservedTasks);
+}
+
 void DeferQueue::Push(DeferTask task) {
   tasks_.push_back(std::move(task));
 }
@@ -9,15 +9,23 @@
 #pragma once
 
 #include <ECS/World.hpp>
+#include <Utils/InplaceFunction.hpp>
 
-#include <functional>
 #include <vector>
 
 namespace ra {
 
 class DeferQueue {
  public:
-  using DeferTask = std::function<void(ecs::World&)>;
+  /* Tasks are stored inline, so that spawning and destroying entities doesn't allocate */
+  static constexpr size_t kTaskCapacity = 64U;
+
+  using DeferTask = utils::InplaceFunction<void(ecs::World&), kTaskCapacity>;
+
+  /* Tasks pushed within a frame before the queue first grows */
+  static constexpr size_t kReservedTasks = 256U;
+
+  DeferQueue();
 
   void Push(DeferTask task);
 
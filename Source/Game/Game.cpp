@@ -12,12 +12,34 @@
 #include <Game/RenderSystems.hpp>
 #include <Game/StarBackground.hpp>
 #include <Game/UpdateSystems.hpp>
+#include <Profile/Profiler.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
-#include <sstream>
+#include <numbers>
 
 namespace ra {
 
+const char* ToString(GameSystem system) {
+  switch (system) {
+    case GameSystem::Input:           { return "input"; }
+    case GameSystem::Movement:        { return "movement"; }
+    case GameSystem::Shooting:        { return "shooting"; }
+    case GameSystem::Emission:        { return "emission"; }
+    case GameSystem::Particles:       { return "particles"; }
+    case GameSystem::Collisions:      { return "collisions"; }
+    case GameSystem::Spawning:        { return "spawning"; }
+    case GameSystem::Background:      { return "background"; }
+    case GameSystem::Polygons:        { return "polygons"; }
+    case GameSystem::ParticlesRaster: { return "particles_raster"; }
+    case GameSystem::UI:              { return "ui"; }
+    case GameSystem::Deferred:        { return "deferred"; }
+    default:                          { return "unknown"; }
+  }
+}
+
 static std::shared_ptr<asset::FontAtlas> g_font_atlas =
     asset::LoadFontAtlas_BMFontAtlas("Assets/font_48/font_48.bmp", "Assets/font_48/font_48.fnt");
 
@@ -33,8 +55,9 @@ void Game::StartNew() {
 
   LoadHighScore();
 
+  particles_ = render::ParticleSystem(kMaxParticles);
+
   explosions_ = world_.NewEntity();
-  world_.Add<render::ParticleSystem>(explosions_) = render::ParticleSystem(2048U);
   world_.Add<render::ParticleSystem::ParticleSpecs>(explosions_) = {
     .origin             = math::Vec2f(0.0f),
     .velocity           = math::Vec2f(0.0f),
@@ -55,8 +78,76 @@ void Game::StartNew() {
   enemies_left_ = 0U;
 }
 
+void Game::StartStress(const StressConfig& config) {
+  StartNew();
+
+  /* Nothing can hit the player, which also stops SpawnNewEnemies from starting new waves */
+  world_.Remove<SphereCollider>(player_);
+  enemies_left_ = static_cast<int32_t>(config.ufos);
+
+  auto& random_gen = utils::Random::Instance();
+
+  /* UFOs in a ring around the player, so that they keep converging on it for a while */
+  for (uint32_t i = 0U; i < config.ufos; ++i) {
+    const float angle    = random_gen.InRange(0.0f, 2.0f * std::numbers::pi_v<float>);
+    const float distance = random_gen.InRange(40.0f, 150.0f);
+    const auto  pos      = distance * math::Vec2f(std::cos(angle), std::sin(angle));
+
+    SpawnUFO(world_, pos, random_gen.InRange(3.0f, 20.0f), player_);
+  }
+
+  /* Slowly drifting projectiles, kept well within DestroyOnFarAway's distance */
+  for (uint32_t i = 0U; i < config.projectiles; ++i) {
+    Transform transform;
+    transform.pos      = random_gen.InRange(math::Vec2f(-150.0f), math::Vec2f(150.0f));
+    transform.rotation = random_gen.InRange(0.0f, 2.0f * std::numbers::pi_v<float>);
+
+    SpawnProjectile(world_, transform, random_gen.InRange(math::Vec2f(-2.0f), math::Vec2f(2.0f)));
+  }
+
+  for (uint32_t i = 0U; i < config.emitters; ++i) {
+    SpawnParticleEmitter(world_, random_gen.InRange(math::Vec2f(-60.0f), math::Vec2f(60.0f)));
+  }
+
+  RA_LOG_INFO("Started stress scene: %u UFOs, %u projectiles, %u emitters", config.ufos, config.projectiles,
+              config.emitters);
+}
+
+namespace {
+
+/* Adds the lifetime of the scope to the system's timing, and to the profile if profiling is enabled */
+class SystemTimer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  SystemTimer(SystemTimings& timings, GameSystem system)
+      : timing_(timings[static_cast<size_t>(system)]),
+#if defined(RA_ENABLE_PROFILING)
+        scope_(ToString(system)),
+#endif
+        start_(Clock::now()) {}
+
+  ~SystemTimer() { timing_ += std::chrono::duration<double, std::nano>(Clock::now() - start_).count(); }
+
+  SystemTimer(const SystemTimer&)            = delete;
+  SystemTimer& operator=(const SystemTimer&) = delete;
+
+ private:
+  double& timing_;
+#if defined(RA_ENABLE_PROFILING)
+  profile::Scope scope_;
+#endif
+  Clock::time_point start_;
+};
+
+}  // namespace
+
 void Game::Update(float dt) {
+  RA_PROFILE_FRAME();
+  RA_PROFILE_SCOPE("Game::Update");
+
   time_ += dt;
+  timings_.fill(0.0);
 
   if (game_over_ && input::CheckKey(input::Key::Enter)) {
       StartNew();
@@ -67,51 +158,88 @@ void Game::Update(float dt) {
     return;
   }
 
-  ProcessZoom();
-
   /* Systems */
-  world_.Run(renderer_, &systems::ProcessInput);
-  world_.Run(dt, &systems::Move);
-  world_.Run(world_, &systems::Follow);
-  world_.Run(&systems::CalculateTransforms);
-  world_.Run(&systems::UpdateColliders);
-
-  systems::ContextShooting context_shooting{.defer_queue = defer_queue_, .dt = dt};
-  world_.Run(context_shooting, &systems::Shoot);
-
-  world_.Run(dt, &systems::EmitPlayerParticles);
-  world_.Run(dt, &systems::EmitUFOParticles);
-  world_.Run(dt, &systems::UpdateParticles);
-
-  systems::ContextCollisionDetection context_collision {
-    .world           = world_,
-    .defer_queue     = defer_queue_,
-    .score           = score_,
-    .enemies_left    = enemies_left_,
-    .game_over       = game_over_,
-    .explosions      = world_.Get<render::ParticleSystem>(explosions_),
-    .explosion_specs = world_.Get<render::ParticleSystem::ParticleSpecs>(explosions_)
-  };
-  world_.template RunInteractions<systems::ContextCollisionDetection, SphereCollider>(context_collision,
-                                                                                      &systems::CollisionDetection);
-
-  systems::ContextSpawnNewEnemies context_spawn{
-    .defer_queue  = defer_queue_,
-    .target       = player_,
-    .enemy_level  = enemy_level_,
-    .enemies_left = enemies_left_
-  };
-  world_.Run(context_spawn, &systems::SpawnNewEnemies);
+  {
+    SystemTimer timer(timings_, GameSystem::Input);
+    ProcessZoom();
+
+    /* Before the first Render the renderer has no view, and the cursor would map to NaN, steering the player away */
+    if (view_set_) {
+      world_.Run("ProcessInput", renderer_, &systems::ProcessInput);
+    }
+  }
+
+  {
+    SystemTimer timer(timings_, GameSystem::Movement);
+
+    /* World::Run profiles every system under its name, these are the iteration-bound ones most sensitive to the
+     * component storage layout */
+    world_.Run("Move", dt, &systems::Move);
+    world_.Run("Follow", world_, &systems::Follow);
+    world_.Run("CalculateTransforms", &systems::CalculateTransforms);
+    world_.Run("UpdateColliders", &systems::UpdateColliders);
+  }
+
+  {
+    SystemTimer timer(timings_, GameSystem::Shooting);
+    systems::ContextShooting context_shooting{.defer_queue = defer_queue_, .dt = dt};
+    world_.Run("Shoot", context_shooting, &systems::Shoot);
+  }
 
-  world_.Run(defer_queue_, &systems::DestroyOnFarAway);
+  {
+    SystemTimer timer(timings_, GameSystem::Emission);
+    systems::ContextEmitParticles context_emit{.particles = particles_};
+    world_.Run("EmitPlayerParticles", context_emit, &systems::EmitPlayerParticles);
+    world_.Run("EmitUFOParticles", context_emit, &systems::EmitUFOParticles);
+    world_.Run("EmitParticles", context_emit, &systems::EmitParticles);
+  }
 
-  executor_.WaitIdle();
+  {
+    SystemTimer timer(timings_, GameSystem::Particles);
+    particles_.Update(dt, executor_);
+  }
+
+  {
+    SystemTimer timer(timings_, GameSystem::Collisions);
+    systems::ContextCollisionDetection context_collision {
+      .world           = world_,
+      .defer_queue     = defer_queue_,
+      .score           = score_,
+      .enemies_left    = enemies_left_,
+      .game_over       = game_over_,
+      .explosions      = particles_,
+      .explosion_specs = world_.Get<render::ParticleSystem::ParticleSpecs>(explosions_)
+    };
+    world_.template RunInteractions<systems::ContextCollisionDetection, SphereCollider>(
+        "CollisionDetection", context_collision, &systems::CollisionDetection);
+  }
+
+  {
+    SystemTimer timer(timings_, GameSystem::Spawning);
+    systems::ContextSpawnNewEnemies context_spawn{
+      .defer_queue  = defer_queue_,
+      .target       = player_,
+      .enemy_level  = enemy_level_,
+      .enemies_left = enemies_left_
+    };
+    world_.Run("SpawnNewEnemies", context_spawn, &systems::SpawnNewEnemies);
+
+    world_.Run("DestroyOnFarAway", defer_queue_, &systems::DestroyOnFarAway);
+  }
+
+  /* Particle jobs run alongside collisions and spawning, the rest of them is waited for here */
+  {
+    SystemTimer timer(timings_, GameSystem::Particles);
+    executor_.WaitIdle();
+  }
 }
 
 void Game::Render(render::ImageView<render::Color>& render_target) {
-  if (stars_data_.image_dist1.Extent() != render_target.Extent()) {
-    stars_data_ = PrecalculateStarPositions(executor_, render_target.Extent());
-    executor_.WaitIdle();
+  RA_PROFILE_SCOPE("Game::Render");
+
+  if (stars_data_.extent != render_target.Extent()) {
+    stars_data_       = PrecalculateStarPositions(executor_, render_target.Extent());
+    background_cache_ = CreateBackgroundCache(stars_data_, kTwinkleRefreshRate);
   }
 
   renderer_.BeginFrame(render_target);
@@ -127,35 +255,93 @@ void Game::Render(render::ImageView<render::Color>& render_target) {
   );
 
   renderer_.CmdSetViewInfo(proj_view, inv_proj_view);
+  view_set_ = true;
 
   /* Background */
-  RenderBackground(executor_, render_target, stars_data_, static_cast<float>(time_));
-  executor_.WaitIdle();
+  {
+    SystemTimer timer(timings_, GameSystem::Background);
+    RenderBackground(background_cache_, renderer_, render_target, stars_data_, static_cast<float>(time_));
+  }
 
   /* Systems */
-  systems::ContextRenderPolygons context_polygons {
-    .renderer = renderer_,
-    .executor = executor_
-  };
-  world_.Run(context_polygons, &systems::RenderPolygons);
+  {
+    SystemTimer timer(timings_, GameSystem::Polygons);
+    systems::ContextRenderPolygons context_polygons {
+      .renderer = renderer_,
+      .executor = executor_
+    };
+    world_.Run("RenderPolygons", context_polygons, &systems::RenderPolygons);
+  }
 
-  systems::ContextRenderParticles context_particles {
-    .renderer = renderer_,
-    .executor = executor_
-  };
-  world_.Run(context_particles, &systems::RenderParticles);
-  executor_.WaitIdle();
+  /* Polygon jobs may still be running here, so part of their time is attributed to particles */
+  {
+    SystemTimer timer(timings_, GameSystem::ParticlesRaster);
+    particles_.Render(renderer_, executor_);
+    executor_.WaitIdle();
+  }
 
   /* UI */
-  RenderUI();
-  executor_.WaitIdle();
+  {
+    SystemTimer timer(timings_, GameSystem::UI);
+    RenderUI();
+    executor_.WaitIdle();
+  }
 
-  defer_queue_.Execute(world_);
-  defer_queue_.Clear();
+  {
+    SystemTimer timer(timings_, GameSystem::Deferred);
+    defer_queue_.Execute(world_);
+    defer_queue_.Clear();
+  }
 
   renderer_.EndFrame();
 }
 
+const render::Renderer::Stats& Game::RenderStats() const {
+  return renderer_.FrameStats();
+}
+
+size_t Game::OverflowedParticleBursts() const {
+  return particles_.OverflowedBursts();
+}
+
+const SystemTimings& Game::LastFrameTimings() const {
+  return timings_;
+}
+
+void Game::ReportMemory(profile::MemoryReport& report) const {
+  world_.ReportMemory(report);
+  particles_.ReportMemory(report, "explosions and engines");
+  renderer_.ReportMemory(report);
+
+  const size_t stars_count = stars_data_.small_stars.size() + stars_data_.big_stars.size();
+  report.Add({.category       = "image",
+              .name           = "PrecalculatedStarsData",
+              .count          = stars_count,
+              .capacity       = stars_data_.small_stars.capacity() + stars_data_.big_stars.capacity(),
+              .used_bytes     = stars_count * sizeof(Star),
+              .reserved_bytes = profile::VectorBytes(stars_data_.small_stars) +
+                                profile::VectorBytes(stars_data_.big_stars)});
+
+  const auto& layer = background_cache_.layer;
+  report.Add({.category       = "image",
+              .name           = "BackgroundCache layer",
+              .count          = static_cast<size_t>(layer.Extent().x) * layer.Extent().y,
+              .capacity       = static_cast<size_t>(layer.Extent().x) * layer.Extent().y,
+              .used_bytes     = layer.SizeBytes(),
+              .reserved_bytes = layer.SizeBytes()});
+
+  /* Glyph tables are stored inline in the atlas */
+  if (g_font_atlas != nullptr && g_font_atlas->image != nullptr) {
+    const auto& image = *g_font_atlas->image;
+    report.Add({.category       = "image",
+                .name           = "FontAtlas",
+                .count          = static_cast<size_t>(image.Extent().x) * image.Extent().y,
+                .capacity       = static_cast<size_t>(image.Extent().x) * image.Extent().y,
+                .used_bytes     = image.SizeBytes() + sizeof(asset::FontAtlas),
+                .reserved_bytes = image.SizeBytes() + sizeof(asset::FontAtlas)});
+  }
+}
+
 void Game::ProcessZoom() {
   if (input::CheckMouseButton(input::MouseButton::WheelUp)) {
     zoom_ += 1;
@@ -165,30 +351,26 @@ void Game::ProcessZoom() {
 }
 
 void Game::RenderUI() {
+  /* Formatted into a stack buffer, text itself is cached by the renderer */
+  std::array<char, 32U> text;
+
   if (game_over_) {
     renderer_.CmdDrawText("Game Over!", math::Vec2f(-0.3f, 0.4f), *g_font_atlas);
 
-    std::stringstream ss;
+    int length = std::snprintf(text.data(), text.size(), "Score: %u", score_);
+    renderer_.CmdDrawText(std::string_view(text.data(), length), math::Vec2f(-0.3f, 0.0f), *g_font_atlas);
 
-    ss << "Score: " << score_;
-    renderer_.CmdDrawText(ss.view(), math::Vec2f(-0.3f, 0.0f), *g_font_atlas);
-    ss = {};
-
-    ss << "Highest: " << highest_score_;
-    renderer_.CmdDrawText(ss.view(), math::Vec2f(-0.3f, -0.2f), *g_font_atlas);
-    ss = {};
+    length = std::snprintf(text.data(), text.size(), "Highest: %u", highest_score_);
+    renderer_.CmdDrawText(std::string_view(text.data(), length), math::Vec2f(-0.3f, -0.2f), *g_font_atlas);
 
     double tmp;
     auto blink = std::modf(2.0f * time_, &tmp);
     blink = math::Lerp(0.5f, 1.0f, blink);
 
-    ss << "Press Enter";
-    renderer_.CmdDrawText(ss.view(), math::Vec2f(-0.3f, -0.6f), *g_font_atlas, blink);
+    renderer_.CmdDrawText("Press Enter", math::Vec2f(-0.3f, -0.6f), *g_font_atlas, blink);
   } else {
-    std::stringstream ss;
-    ss << "SCORE: " << score_;
-
-    renderer_.CmdDrawText(ss.view(), math::Vec2f(-0.95f, 0.95f), *g_font_atlas);
+    int length = std::snprintf(text.data(), text.size(), "SCORE: %u", score_);
+    renderer_.CmdDrawText(std::string_view(text.data(), length), math::Vec2f(-0.95f, 0.95f), *g_font_atlas);
   }
 }
 
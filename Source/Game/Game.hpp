@@ -15,17 +15,65 @@
 #include <Render/ParticleSystem.hpp>
 #include <Render/Renderer.hpp>
 
+#include <array>
+
 namespace ra {
 
+/* Stages of a frame, timed separately so that their scaling can be tracked */
+enum class GameSystem : uint32_t {
+  Input,
+  Movement,
+  Shooting,
+  Emission,
+  Particles,
+  Collisions,
+  Spawning,
+  Background,
+  Polygons,
+  ParticlesRaster,
+  UI,
+  Deferred,
+
+  Count
+};
+
+[[nodiscard]] const char* ToString(GameSystem system);
+
+/* Wall clock time of every GameSystem during the last frame in nanoseconds */
+using SystemTimings = std::array<double, static_cast<size_t>(GameSystem::Count)>;
+
+/* Population of a stress scene, see Game::StartStress */
+struct StressConfig {
+  uint32_t ufos{0U};
+  uint32_t projectiles{0U};
+  uint32_t emitters{0U};
+};
+
 class Game {
  public:
   ~Game();
 
   void StartNew();
 
+  /**
+   * Starts a new game with `config.ufos` UFOs, `config.projectiles` projectiles and `config.emitters` particle emitters
+   * spawned around an invulnerable player. No new enemy waves are spawned, so the population only shrinks as UFOs and
+   * projectiles are destroyed.
+   */
+  void StartStress(const StressConfig& config);
+
   void Update(float dt);
   void Render(render::ImageView<render::Color>& render_target);
 
+  const render::Renderer::Stats& RenderStats() const;
+  const SystemTimings&           LastFrameTimings() const;
+
+  /* Particle bursts of the last update that took the locked overflow path, see ParticleSystem::EmitBurst */
+  size_t OverflowedParticleBursts() const;
+
+  /* Adds memory of the world, particles, renderer, background and font */
+  void ReportMemory(profile::MemoryReport& report) const;
+
  protected:
   void ProcessZoom();
   void RenderUI();
@@ -33,11 +81,18 @@ class Game {
   void LoadHighScore();
   void StoreHighScore();
 
+  /* Upper bound of particles alive at once, storage only grows as far as needed */
+  static constexpr size_t kMaxParticles = 1U << 17U;
+
+  /* Stars twinkle slowly, so the background layer is refreshed less often than frames are rendered */
+  static constexpr float kTwinkleRefreshRate = 20.0f;
+
   job::Executor    executor_;
   render::Renderer renderer_;
 
-  ecs::World world_;
-  DeferQueue defer_queue_;
+  ecs::World             world_;
+  DeferQueue             defer_queue_;
+  render::ParticleSystem particles_;
 
   double   time_{0.0};
   int32_t  zoom_{25};
@@ -45,6 +100,7 @@ class Game {
   uint32_t highest_score_{0U};
   bool     score_saved_{false};
   bool     game_over_{false};
+  bool     view_set_{false};  // Whether a frame has been rendered, so the cursor can be mapped into the world
 
   ecs::EntityId player_;
   int32_t       enemy_level_{0};
@@ -52,6 +108,9 @@ class Game {
 
   ecs::EntityId explosions_;
   PrecalculatedStarsData stars_data_;
+  BackgroundCache        background_cache_;
+
+  SystemTimings timings_{};
 };
 
 }  // namespace ra
\ No newline at end of file
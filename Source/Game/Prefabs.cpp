@@ -32,9 +32,6 @@ ecs::EntityId SpawnPlayer(ecs::World& world) {
   sphere_collider.ms_pos    = math::Vec2f(0.0f, 0.7f);
   sphere_collider.ms_radius = std::sqrt(2.2525f);
 
-  auto& particle_system = world.Add<render::ParticleSystem>(player);
-  particle_system       = render::ParticleSystem(2048U);
-
   auto& particle_specs          = world.Add<render::ParticleSystem::ParticleSpecs>(player);
   particle_specs.color_begin    = math::Vec4f(0.05f, 0.2f, 0.8f, 1.0f);
   particle_specs.color_end      = math::Vec4f(0.2f, 0.6f, 0.8f, 1.0f);
@@ -68,9 +65,6 @@ ecs::EntityId SpawnUFO(ecs::World& world, math::Vec2f pos, float speed, ecs::Ent
   sphere_collider.ms_pos    = math::Vec2f(0.0f, 0.2f);
   sphere_collider.ms_radius = std::sqrt(1.73f);
 
-  auto& particle_system = world.Add<render::ParticleSystem>(ufo);
-  particle_system       = render::ParticleSystem(2048U);
-
   auto& particle_specs          = world.Add<render::ParticleSystem::ParticleSpecs>(ufo);
   particle_specs.color_begin    = math::Vec4f(0.4f, 0.8f, 0.2f, 1.0f);
   particle_specs.color_end      = math::Vec4f(0.4f, 0.6f, 0.4f, 0.8f);
@@ -99,4 +93,24 @@ ecs::EntityId SpawnProjectile(ecs::World& world, const Transform& transform, mat
   return projectile;
 }
 
+ecs::EntityId SpawnParticleEmitter(ecs::World& world, math::Vec2f pos) {
+  auto emitter = world.NewEntity();
+
+  world.Add<Transform>(emitter).pos = pos;
+  world.Add<ParticleEmitter>(emitter);
+
+  auto& particle_specs              = world.Add<render::ParticleSystem::ParticleSpecs>(emitter);
+  particle_specs.origin             = pos;
+  particle_specs.velocity           = math::Vec2f(0.0f, 4.0f);
+  particle_specs.velocity_variation = math::Vec2f(6.0f, 6.0f);
+  particle_specs.color_begin        = math::Vec4f(0.9f, 0.3f, 0.6f, 1.0f);
+  particle_specs.color_end          = math::Vec4f(0.3f, 0.2f, 0.9f, 0.0f);
+  particle_specs.size_begin         = 0.02f;
+  particle_specs.size_end           = 0.005f;
+  particle_specs.size_variation     = 0.005f;
+  particle_specs.lifetime           = 0.5f;
+
+  return emitter;
+}
+
 }  // namespace ra
\ No newline at end of file
@@ -19,5 +19,6 @@ ecs::EntityId SpawnPlayer(ecs::World& world);
 ecs::EntityId SpawnUFO(ecs::World& world, math::Vec2f pos, float speed, ecs::EntityId target);
 
 ecs::EntityId SpawnProjectile(ecs::World& world, const Transform& transform, math::Vec2f velocity);
+ecs::EntityId SpawnParticleEmitter(ecs::World& world, math::Vec2f pos);
 
 }  // namespace ra
\ No newline at end of file
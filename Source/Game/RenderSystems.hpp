@@ -10,9 +10,10 @@
 
 #include <Game/Components.hpp>
 #include <JobSystem/Executor.hpp>
-#include <Render/ParticleSystem.hpp>
+#include <Profile/Profiler.hpp>
 #include <Render/Renderer.hpp>
 
+#include <array>
 #include <span>
 
 namespace ra::systems {
@@ -25,27 +26,43 @@ struct ContextRenderPolygons {
 void RenderPolygons(ContextRenderPolygons& context,
                     std::span<const TransformMatrix> matrices,
                     std::span<const PolygonRenderer> polygons) {
+  constexpr size_t kCullBatchSize = 64U;
+
+  std::array<float, kCullBatchSize>   ws_x;
+  std::array<float, kCullBatchSize>   ws_y;
+  std::array<float, kCullBatchSize>   ws_radius;
+  std::array<uint8_t, kCullBatchSize> visible;
+
   const auto size = matrices.size();
 
-  for (auto i = 0U; i < size; ++i) {
-    context.executor.Submit([=]() {
-      context.renderer.CmdDrawPolygon(*polygons[i].polygon, matrices[i].matrix);
-    });
-  }
-}
+  for (size_t batch_start = 0U; batch_start < size; batch_start += kCullBatchSize) {
+    const auto batch_size = std::min(kCullBatchSize, size - batch_start);
 
-struct ContextRenderParticles {
-  render::Renderer& renderer;
-  job::Executor&    executor;
-};
+    /* Gather world space bounding circles into SoA batch */
+    for (size_t i = 0U; i < batch_size; ++i) {
+      const auto& m      = matrices[batch_start + i].matrix.elements;
+      const auto& bounds = polygons[batch_start + i].polygon->ms_bounds;
+
+      const float scale_squared = std::max(m[0] * m[0] + m[3] * m[3], m[1] * m[1] + m[4] * m[4]);
+
+      ws_x[i]      = m[0] * bounds.center.x + m[1] * bounds.center.y + m[2];
+      ws_y[i]      = m[3] * bounds.center.x + m[4] * bounds.center.y + m[5];
+      ws_radius[i] = bounds.radius * std::sqrt(scale_squared);
+    }
+
+    context.renderer.CullCircles(std::span(ws_x).first(batch_size), std::span(ws_y).first(batch_size),
+                                 std::span(ws_radius).first(batch_size), std::span(visible).first(batch_size));
 
-void RenderParticles(ContextRenderParticles& context, std::span<render::ParticleSystem> particle_systems) {
-  const auto size = particle_systems.size();
+    for (size_t i = 0U; i < batch_size; ++i) {
+      if (!visible[i]) {
+        continue;
+      }
 
-  for (auto i = 0U; i < size; ++i) {
-    context.executor.Submit([=]() {
-      particle_systems[i].Render(context.renderer);
-    });
+      context.executor.Submit([=, idx = batch_start + i]() {
+        RA_PROFILE_SCOPE("RenderPolygons job");
+        context.renderer.CmdDrawPolygon(*polygons[idx].polygon, matrices[idx].matrix);
+      });
+    }
   }
 }
 
@@ -9,11 +9,22 @@
 #include <Game/StarBackground.hpp>
 
 #include <JobSystem/Executor.hpp>
+#include <Math/FastTrig.hpp>
+#include <Profile/Profiler.hpp>
+#include <Render/Renderer.hpp>
+#include <Utils/Assert.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 namespace ra {
 
-static constexpr float kSize = 4.0f;
-static constexpr float kProb = 0.998f;
+static constexpr float    kSize      = 4.0f;
+static constexpr uint32_t kCellSize  = 4U;  // kSize in pixels
+static constexpr float    kProb      = 0.998f;
+static constexpr float    kSmallProb = 0.996f;
+
+static const render::Color kBackgroundColor = render::Color(math::Vec4f(0.0f, 0.0f, 0.0f, 1.0f));
 
 static inline float Random(math::Vec2f co) {
   float tmp;
@@ -22,36 +33,51 @@ static inline float Random(math::Vec2f co) {
 
 PrecalculatedStarsData PrecalculateStarPositions(job::Executor& executor, math::Vec2u extent) {
   PrecalculatedStarsData stars_data;
-
-  stars_data.image_dist1 = render::Image<math::Vec4f>(extent);
-  stars_data.image_dist2 = render::Image<float>(extent);
-  stars_data.view_dist1  = stars_data.image_dist1.CreateView();
-  stars_data.view_dist2  = stars_data.image_dist2.CreateView();
+  stars_data.extent = extent;
 
   auto  work_group_count = executor.ThreadCount();
   auto  work_group_size  = (extent.y + executor.ThreadCount() - 1U) / executor.ThreadCount();
 
+  RA_ASSERT(extent.x <= UINT16_MAX && extent.y <= UINT16_MAX, "Star positions are 16-bit, extent = (%u, %u)", extent.x,
+            extent.y);
+
+  /* Each work group collects stars of its rows, lists are concatenated in order afterwards */
+  std::vector<PrecalculatedStarsData> work_group_stars(work_group_count);
+
   for (uint32_t work_group = 0U; work_group < work_group_count; ++work_group) {
     executor.Submit([&, work_group]() {
+      RA_PROFILE_SCOPE("PrecalculateStarPositions work group");
+      auto& stars = work_group_stars[work_group];
+
       for (uint32_t y = 0U; y < work_group_size; ++y) {
         const uint32_t final_y = work_group * work_group_size + y;
+        if (final_y >= extent.y) {
+          break;
+        }
 
         for (uint32_t x = 0U; x < extent.x; ++x) {
           auto fcoords = math::Vec2f(x, final_y);
 
-          math::Vec4f dist1;
-          dist1.x = Random(fcoords);
-
-          {
-            auto pos = 1.0f / kSize * fcoords;
-            pos      = math::Vec2f(std::floor(pos.x), std::floor(pos.y));
-            dist1.y  = pos.x;
-            dist1.z  = pos.y;
-            dist1.w  = Random(pos);
+          auto pos        = 1.0f / kSize * fcoords;
+          pos             = math::Vec2f(std::floor(pos.x), std::floor(pos.y));
+          auto star_value = Random(pos);
+
+          /* Whole cell belongs to a big star, it's emitted once from its top-left pixel */
+          if (star_value > kProb) {
+            if (x % kCellSize == 0U && final_y % kCellSize == 0U) {
+              stars.big_stars.push_back({
+                .x     = static_cast<uint16_t>(x),
+                .y     = static_cast<uint16_t>(final_y),
+                .phase = (star_value - kProb) / (1.0f - kProb) * 45.0f
+              });
+            }
+          } else if (Random(fcoords) > kSmallProb) {
+            stars.small_stars.push_back({
+              .x     = static_cast<uint16_t>(x),
+              .y     = static_cast<uint16_t>(final_y),
+              .phase = Random(fcoords / math::Vec2f(extent))
+            });
           }
-
-          stars_data.view_dist1(x, final_y) = dist1;
-          stars_data.view_dist2(x, final_y) = Random(fcoords / math::Vec2f(extent));
         }
       }
     });
@@ -59,52 +85,107 @@ PrecalculatedStarsData PrecalculateStarPositions(job::Executor& executor, math::
 
   executor.WaitIdle();
 
+  for (const auto& stars : work_group_stars) {
+    stars_data.small_stars.insert(stars_data.small_stars.end(), stars.small_stars.begin(), stars.small_stars.end());
+    stars_data.big_stars.insert(stars_data.big_stars.end(), stars.big_stars.begin(), stars.big_stars.end());
+  }
+
   return stars_data;
 }
 
-static math::Vec4f PixelShader(const PrecalculatedStarsData& stars_data, math::Vec2u ucoords, float time) {
-  auto coords = math::Vec2f(ucoords);
-  auto color  = 0.0f;
+static void SplatBigStar(render::ImageView<render::Color>& render_target, const Star& star, float time) {
+  const auto  extent = render_target.Extent();
+  math::Vec2f center = math::Vec2f(star.x, star.y) + math::Vec2f(kSize, kSize) * 0.5f;
 
-  auto dist1      = stars_data.view_dist1(ucoords.x, ucoords.y);
-  auto pos        = math::Vec2f(dist1.y, dist1.z);
-  auto star_value = dist1.w;
+  float t = 0.9f + 0.2f * math::FastSin(time + star.phase);
 
-  if (star_value > kProb) {
-    math::Vec2f center = kSize * pos + math::Vec2f(kSize, kSize) * 0.5f;
+  for (uint32_t y = star.y; y < std::min<uint32_t>(star.y + kCellSize, extent.y); ++y) {
+    for (uint32_t x = star.x; x < std::min<uint32_t>(star.x + kCellSize, extent.x); ++x) {
+      auto coords = math::Vec2f(x, y);
 
-    float t = 0.9f + 0.2f * std::sin(time + (star_value - kProb) / (1.0f - kProb) * 45.0f);
+      auto color = 1.0f - math::Length(coords - center) / (0.5f * kSize);
+      color      = color * t / (std::abs(coords.y - center.y)) * t / (std::abs(coords.x - center.x));
 
-    color = 1.0f - math::Length(coords - center) / (0.5f * kSize);
-    color = color * t / (std::abs(coords.y - center.y)) * t / (std::abs(coords.x - center.x));
-  } else if (dist1.x > 0.996f) {
-    float r = stars_data.view_dist2(ucoords.x, ucoords.y);
-    color   = r * (0.25f * std::sin(time * (r * 5.0f) + 720.0f * r) + 0.75f);
+      render_target(x, y) = render::Color(math::Vec4f(color, color, color, 1.0f));
+    }
   }
+}
+
+static void SplatSmallStar(render::ImageView<render::Color>& render_target, const Star& star, float time) {
+  float r     = star.phase;
+  float color = r * (0.25f * math::FastSin(time * (r * 5.0f) + 720.0f * r) + 0.75f);
+
+  render_target(star.x, star.y) = render::Color(math::Vec4f(color, color, color, 1.0f));
+}
+
+static void SplatStars(render::ImageView<render::Color>& render_target, const PrecalculatedStarsData& stars_data,
+                       float time) {
+  for (const auto& star : stars_data.small_stars) {
+    SplatSmallStar(render_target, star, time);
+  }
+
+  for (const auto& star : stars_data.big_stars) {
+    SplatBigStar(render_target, star, time);
+  }
+}
+
+BackgroundCache CreateBackgroundCache(const PrecalculatedStarsData& stars_data, float twinkle_refresh_rate) {
+  BackgroundCache cache;
+  cache.layer          = render::Image<render::Color>(stars_data.extent);
+  cache.twinkle_period = 1.0f / twinkle_refresh_rate;
+
+  /* Star pixels are fixed, so pixels outside of them are cleared once and never touched again */
+  auto layer = cache.layer.CreateView();
+  auto data  = layer.Data();
+  std::fill(data.begin(), data.end(), kBackgroundColor);
 
-  return math::Vec4f(color, color, color, 1.0f);
+  return cache;
 }
 
-void RenderBackground(job::Executor& executor, render::ImageView<render::Color>& render_target,
+void RenderBackground(render::Renderer& renderer, render::ImageView<render::Color>& render_target,
                       const PrecalculatedStarsData& stars_data, float time) {
-  const auto extent  = static_cast<math::Vec2u>(render_target.Extent());
+  RA_PROFILE_SCOPE("RenderBackground");
 
-  auto  work_group_count = executor.ThreadCount();
-  auto  work_group_size  = (extent.y + executor.ThreadCount() - 1U) / executor.ThreadCount();
+  renderer.CmdClear(kBackgroundColor);
+  SplatStars(render_target, stars_data, time);
+}
 
-  for (uint32_t work_group = 0U; work_group < work_group_count; ++work_group) {
-    executor.Submit([=, &stars_data]() {
-      for (uint32_t y = 0U; y < work_group_size; ++y) {
-        const uint32_t final_y = work_group * work_group_size + y;
+void RenderBackground(BackgroundCache& cache, render::Renderer& renderer, render::ImageView<render::Color>& render_target,
+                      const PrecalculatedStarsData& stars_data, float time) {
+  RA_PROFILE_SCOPE("RenderBackground");
 
-        for (uint32_t x = 0U; x < extent.x; ++x) {
-          render_target(x, final_y) = render::Color(PixelShader(stars_data, math::Vec2u(x, final_y), time));
-        }
-      }
-    });
+  auto layer = cache.layer.CreateView();
+
+  RA_ASSERT(layer.Extent() == render_target.Extent(), "Background cache must be recreated on resize");
+
+  /* Time going backwards (e.g. a restarted clock) refreshes the layer as well */
+  if (time - cache.twinkle_time >= cache.twinkle_period || time < cache.twinkle_time) {
+    RA_PROFILE_SCOPE("RenderBackground refresh");
+
+    SplatStars(layer, stars_data, time);
+    cache.twinkle_time = time;
+
+    /* Star pixels outside of the restore regions are updated in place */
+    SplatStars(render_target, stars_data, time);
+
+    for (const auto& star : stars_data.small_stars) {
+      renderer.MarkDamaged({.offset = math::Vec2u(star.x, star.y), .extent = math::Vec2u(1U)});
+    }
+
+    for (const auto& star : stars_data.big_stars) {
+      renderer.MarkDamaged({.offset = math::Vec2u(star.x, star.y), .extent = math::Vec2u(kCellSize)});
+    }
   }
 
-  executor.WaitIdle();
+  RA_PROFILE_SCOPE("RenderBackground restore");
+
+  for (const auto& region : renderer.RestoreRegions()) {
+    const size_t row_size = region.extent.x * sizeof(render::Color);
+
+    for (uint32_t y = region.offset.y; y < region.offset.y + region.extent.y; ++y) {
+      std::memcpy(&render_target(region.offset.x, y), &layer(region.offset.x, y), row_size);
+    }
+  }
 }
 
-}  // namespace ra
\ No newline at end of file
+}  // namespace ra
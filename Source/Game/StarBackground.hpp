@@ -12,23 +12,67 @@
 #include <Render/Image.hpp>
 #include <Render/ImageView.hpp>
 
+#include <limits>
+#include <vector>
+
 namespace ra {
 
 namespace job {
 class Executor;
 }  // namespace job
 
+namespace render {
+class Renderer;
+}  // namespace render
+
+/**
+ * Small stars are single pixels, big ones are crosses spanning a 4x4 pixel cell, in which case position is the
+ * top-left pixel of the cell.
+ */
+struct Star {
+  uint16_t x;
+  uint16_t y;
+  float    phase;  // Twinkle phase of a big star, brightness (and twinkle frequency) of a small one
+};
+
+static_assert(sizeof(Star) == 8U, "Stars are expected to be tightly packed");
+
+/**
+ * Only ~0.2% of pixels contain a star, so the background is stored as sparse lists of stars, which are splatted on
+ * top of a cleared render target. At 1024x768 that's ~12 KB instead of 20 bytes per pixel of dense images.
+ */
 struct PrecalculatedStarsData {
-  render::Image<math::Vec4f> image_dist1;  // x = distr, yz = pos, w = star_value
-  render::Image<float>       image_dist2;
+  math::Vec2u       extent{0U};
+  std::vector<Star> small_stars;
+  std::vector<Star> big_stars;
+};
 
-  render::ImageView<math::Vec4f> view_dist1;
-  render::ImageView<float>       view_dist2;
+/**
+ * Background rendered into a separate layer, which is refreshed only `twinkle_refresh_rate` times per second and only
+ * at star pixels. Every frame the layer is just copied into the render target.
+ */
+struct BackgroundCache {
+  render::Image<render::Color> layer;
+
+  float twinkle_period{0.0f};
+  float twinkle_time{-std::numeric_limits<float>::infinity()};  // Time the layer was last refreshed at
 };
 
 PrecalculatedStarsData PrecalculateStarPositions(job::Executor& executor, math::Vec2u extent);
 
-void RenderBackground(job::Executor& executor, render::ImageView<render::Color>& render_target,
+BackgroundCache CreateBackgroundCache(const PrecalculatedStarsData& stars_data, float twinkle_refresh_rate);
+
+/**
+ * Clears the render target and splats all stars.
+ */
+void RenderBackground(render::Renderer& renderer, render::ImageView<render::Color>& render_target,
+                      const PrecalculatedStarsData& stars_data, float time);
+
+/**
+ * Refreshes the cached layer if the twinkle period has passed and copies it into the renderer's restore regions, i.e.
+ * only where objects were drawn last frame. Twinkling star pixels are reported to the renderer as damaged.
+ */
+void RenderBackground(BackgroundCache& cache, render::Renderer& renderer, render::ImageView<render::Color>& render_target,
                       const PrecalculatedStarsData& stars_data, float time);
 
-}  // namespace ra
\ No newline at end of file
+}  // namespace ra
@@ -70,9 +70,14 @@ void Follow(ecs::World& world, const FollowTarget& target, const Transform& tran
     return;
   }
 
-  const auto& target_transform = world.Get<Transform>(target.target.value());
-  auto        forward          = math::Normalize(target_transform.pos - transform.pos);
-  velocity.velocity            = forward * target.speed;
+  /* Target might have been destroyed, e.g. the player flying too far away */
+  const auto* target_transform = world.TryGet<Transform>(target.target.value());
+  if (target_transform == nullptr) {
+    return;
+  }
+
+  auto forward      = math::Normalize(target_transform->pos - transform.pos);
+  velocity.velocity = forward * target.speed;
 }
 
 void Move(float& dt, std::span<const Velocity> velocities, std::span<Transform> transforms) {
@@ -140,9 +145,14 @@ void Shoot(ContextShooting& context, Shooting& shooting, const Transform& transf
   shooting.recharge_current = shooting.recharge;
 }
 
-void EmitPlayerParticles(float &, const InputController&, const Transform& transform, const TransformMatrix& transform_matrix,
-                         const Velocity& velocity, render::ParticleSystem::ParticleSpecs& particle_specs,
-                         render::ParticleSystem& particle_system) {
+/* Emitters are entities with ParticleSpecs, they all emit into the world-wide particle pool */
+struct ContextEmitParticles {
+  render::ParticleSystem& particles;
+};
+
+void EmitPlayerParticles(ContextEmitParticles& context, const InputController&, const Transform& transform,
+                         const TransformMatrix& transform_matrix, const Velocity& velocity,
+                         render::ParticleSystem::ParticleSpecs& particle_specs) {
   const auto rotation_matrix = math::RotationMatrix(transform.rotation);
   auto forward = math::Vec2f(rotation_matrix * math::Vec3f(0.0f, 1.0f, 1.0f));
   auto right   = math::NormalClockwise(forward);
@@ -157,15 +167,12 @@ void EmitPlayerParticles(float &, const InputController&, const Transform& trans
 
   for (const auto& pos : positions) {
     particle_specs.origin = pos;
-
-    for (uint32_t i = 0; i < 22U; ++i) {
-      particle_system.EmitParticle(particle_specs);
-    }
+    context.particles.EmitBurst(particle_specs, 22U);
   }
 }
 
-void EmitUFOParticles(float&, const FollowTarget&, const TransformMatrix& transform_matrix,
-                      render::ParticleSystem::ParticleSpecs& particle_specs, render::ParticleSystem& particle_system) {
+void EmitUFOParticles(ContextEmitParticles& context, const FollowTarget&, const TransformMatrix& transform_matrix,
+                      render::ParticleSystem::ParticleSpecs& particle_specs) {
   particle_specs.velocity           = math::Vec2f(0.0f, -5.0f);
   particle_specs.velocity_variation = math::Vec2f(5.0f, 2.0f);
 
@@ -178,18 +185,14 @@ void EmitUFOParticles(float&, const FollowTarget&, const TransformMatrix& transf
 
   for (const auto& pos : positions) {
     particle_specs.origin = pos;
-
-    for (uint32_t i = 0; i < 12U; ++i) {
-      particle_system.EmitParticle(particle_specs);
-    }
+    context.particles.EmitBurst(particle_specs, 12U);
   }
 }
 
-void UpdateParticles(float& dt, std::span<render::ParticleSystem> particle_systems) {
-  const auto size = particle_systems.size();
-  for (auto i = 0U; i < size; ++i) {
-    particle_systems[i].Update(dt);
-  }
+void EmitParticles(ContextEmitParticles& context, const ParticleEmitter& emitter, const Transform& transform,
+                   render::ParticleSystem::ParticleSpecs& particle_specs) {
+  particle_specs.origin = transform.pos;
+  context.particles.EmitBurst(particle_specs, emitter.burst_size);
 }
 
 struct ContextCollisionDetection {
@@ -232,25 +235,17 @@ void CollisionDetection(ContextCollisionDetection& context, ecs::EntityId first,
     auto& health = world.Get<Health>(second);
     health.value -= damage->value;
 
-    auto        explosion_position = world.Get<Transform>(second).pos;
-    auto&       random_gen         = utils::Random::Instance();
-    math::Vec2f area(2.0f, 2.0f);
-
+    /* Small random velocity of each explosion particle is negligible compared to the variation, so it's folded in */
+    context.explosion_specs.origin             = world.Get<Transform>(second).pos;
+    context.explosion_specs.origin_variation   = math::Vec2f(2.0f, 2.0f);
+    context.explosion_specs.velocity           = math::Vec2f(0.0f);
     context.explosion_specs.size_begin         = 0.004f;
     context.explosion_specs.size_end           = 0.001f;
     context.explosion_specs.size_variation     = 0.001f;
     context.explosion_specs.lifetime           = 0.1f;
-    context.explosion_specs.velocity_variation = math::Vec2f(100.0f);
+    context.explosion_specs.velocity_variation = math::Vec2f(100.0f + 3.0f);
 
-    for (uint32_t i = 0U; i < 8U; ++i) {
-      math::Vec2f random_dir{random_gen.InRange(-0.5f, 0.5f), random_gen.InRange(-0.5f, 0.5f)};
-      math::Vec2f random_offset{random_gen.InRange(-0.5f, 0.5f), random_gen.InRange(-0.5f, 0.5f)};
-
-      context.explosion_specs.origin   = explosion_position + area * random_offset;
-      context.explosion_specs.velocity = 3.0f * random_dir;
-
-      context.explosions.EmitParticle(context.explosion_specs);
-    }
+    context.explosions.EmitBurst(context.explosion_specs, 8U);
 
     context.defer_queue.Push([first](ecs::World& world) {
       world.DestroyEntity(first);
@@ -260,23 +255,14 @@ void CollisionDetection(ContextCollisionDetection& context, ecs::EntityId first,
       context.score += 10;
       --context.enemies_left;
 
-      area = math::Vec2f(3.0f, 3.0f);
-
+      context.explosion_specs.origin_variation   = math::Vec2f(3.0f, 3.0f);
       context.explosion_specs.size_begin         = 0.01f;
       context.explosion_specs.size_end           = 0.005f;
       context.explosion_specs.size_variation     = 0.005f;
       context.explosion_specs.lifetime           = 0.2f;
-      context.explosion_specs.velocity_variation = math::Vec2f(75.0f);
-
-      for (uint32_t i = 0U; i < 32U; ++i) {
-        math::Vec2f random_dir{random_gen.InRange(-0.5f, 0.5f), random_gen.InRange(-0.5f, 0.5f)};
-        math::Vec2f random_offset{random_gen.InRange(-0.5f, 0.5f), random_gen.InRange(-0.5f, 0.5f)};
-
-        context.explosion_specs.origin   = explosion_position + area * random_offset;
-        context.explosion_specs.velocity = 3.0f * random_dir;
+      context.explosion_specs.velocity_variation = math::Vec2f(75.0f + 3.0f);
 
-        context.explosions.EmitParticle(context.explosion_specs);
-      }
+      context.explosions.EmitBurst(context.explosion_specs, 32U);
 
       context.defer_queue.Push([second](ecs::World& world) {
         world.DestroyEntity(second);
@@ -327,7 +313,7 @@ void SpawnNewEnemies(ContextSpawnNewEnemies& context, const InputController&, co
   context.enemies_left = to_spawn;
 }
 
-void DestroyOnFarAway(DeferQueue& defer_queue, const std::unordered_map<uint64_t, ecs::EntityId>& idx_to_entity,
+void DestroyOnFarAway(DeferQueue& defer_queue, const std::vector<ecs::EntityId>& idx_to_entity,
                       std::span<const Transform> transforms) {
   constexpr float kMaxDistance = 200.0f;
 
@@ -337,7 +323,7 @@ void DestroyOnFarAway(DeferQueue& defer_queue, const std::unordered_map<uint64_t
       continue;
     }
 
-    defer_queue.Push([entity = idx_to_entity.at(i)](ecs::World& world) {
+    defer_queue.Push([entity = idx_to_entity[i]](ecs::World& world) {
       world.DestroyEntity(entity);
     });
   }
@@ -8,10 +8,15 @@
 
 #include <Template/Engine.h>
 #include <Input/Keyboard.hpp>
+#include <Input/Recording.hpp>
 
 namespace ra::input {
 
 bool CheckKey(Key key) {
+  if (const auto* frame = GetPlaybackFrame(); frame) {
+    return (frame->keys >> static_cast<uint32_t>(key)) & 1U;
+  }
+
   return is_key_pressed(static_cast<int>(key));
 }
 
@@ -8,15 +8,24 @@
 
 #include <Template/Engine.h>
 #include <Input/Mouse.hpp>
+#include <Input/Recording.hpp>
 #include <Utils/Log.hpp>
 
 namespace ra::input {
 
 bool CheckMouseButton(MouseButton button) {
+  if (const auto* frame = GetPlaybackFrame(); frame) {
+    return (frame->mouse_buttons >> static_cast<uint32_t>(button)) & 1U;
+  }
+
   return is_mouse_button_pressed(static_cast<int>(button));
 }
 
 std::optional<math::Vec2u> GetCursorPosition() {
+  if (const auto* frame = GetPlaybackFrame(); frame) {
+    return frame->cursor_valid ? std::optional(math::Vec2u(frame->cursor_x, frame->cursor_y)) : std::nullopt;
+  }
+
   auto pos = math::Vec2i(get_cursor_x(), get_cursor_y());
   if (pos.x < 0 || pos.x >= SCREEN_WIDTH || pos.y < 0 || pos.y >= SCREEN_HEIGHT) {
     return std::nullopt;
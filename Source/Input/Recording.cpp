@@ -0,0 +1,119 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Recording.cpp
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Input/Recording.hpp>
+
+#include <Input/Keyboard.hpp>
+#include <Input/Mouse.hpp>
+#include <Utils/Log.hpp>
+
+#include <array>
+#include <fstream>
+
+namespace ra::input {
+
+static constexpr std::array<char, 4U> kMagic   = {'R', 'A', 'I', 'N'};
+static constexpr uint32_t             kVersion = 1U;
+static constexpr uint32_t             kKeys    = static_cast<uint32_t>(Key::Enter) + 1U;
+static constexpr uint32_t             kButtons = static_cast<uint32_t>(MouseButton::WheelDown) + 1U;
+
+static const FrameInput* g_playback_frame = nullptr;
+
+struct Header {
+  std::array<char, 4U> magic;
+  uint32_t             version;
+  uint64_t             seed;
+  uint32_t             frames_count;
+  uint32_t             reserved{0U};
+};
+
+static_assert(sizeof(Header) == 24U, "Header must not have padding, it's written as is");
+
+FrameInput CaptureFrameInput(float dt) {
+  FrameInput frame{.dt = dt};
+
+  for (uint32_t key = 0U; key < kKeys; ++key) {
+    frame.keys |= static_cast<uint8_t>(CheckKey(static_cast<Key>(key)) << key);
+  }
+
+  for (uint32_t button = 0U; button < kButtons; ++button) {
+    frame.mouse_buttons |= static_cast<uint8_t>(CheckMouseButton(static_cast<MouseButton>(button)) << button);
+  }
+
+  if (auto cursor = GetCursorPosition(); cursor) {
+    frame.cursor_x     = static_cast<uint16_t>(cursor->x);
+    frame.cursor_y     = static_cast<uint16_t>(cursor->y);
+    frame.cursor_valid = 1U;
+  }
+
+  return frame;
+}
+
+void SetPlaybackFrame(const FrameInput* frame) {
+  g_playback_frame = frame;
+}
+
+const FrameInput* GetPlaybackFrame() {
+  return g_playback_frame;
+}
+
+bool SaveRecording(const std::filesystem::path& filepath, const Recording& recording) {
+  std::ofstream fs(filepath, std::ios::out | std::ios::binary);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  const Header header{.magic        = kMagic,
+                      .version      = kVersion,
+                      .seed         = recording.seed,
+                      .frames_count = static_cast<uint32_t>(recording.frames.size())};
+
+  fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fs.write(reinterpret_cast<const char*>(recording.frames.data()), recording.frames.size() * sizeof(FrameInput));
+
+  if (!fs) {
+    RA_LOG_ERROR("Failed to write input recording \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  RA_LOG_INFO("Saved input recording \"%s\" (%zu frames)", filepath.c_str(), recording.frames.size());
+  return true;
+}
+
+std::optional<Recording> LoadRecording(const std::filesystem::path& filepath) {
+  RA_LOG_INFO("Loading input recording \"%s\"...", filepath.c_str());
+
+  std::ifstream fs(filepath, std::ios::in | std::ios::binary);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return std::nullopt;
+  }
+
+  Header header;
+  if (!fs.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic) {
+    RA_LOG_ERROR("\"%s\" is not an input recording", filepath.c_str());
+    return std::nullopt;
+  }
+
+  if (header.version != kVersion) {
+    RA_LOG_ERROR("Unsupported input recording version %u (expected %u)", header.version, kVersion);
+    return std::nullopt;
+  }
+
+  Recording recording{.seed = header.seed, .frames = std::vector<FrameInput>(header.frames_count)};
+
+  if (!fs.read(reinterpret_cast<char*>(recording.frames.data()), recording.frames.size() * sizeof(FrameInput))) {
+    RA_LOG_ERROR("Input recording \"%s\" is truncated", filepath.c_str());
+    return std::nullopt;
+  }
+
+  return recording;
+}
+
+}  // namespace ra::input
@@ -0,0 +1,60 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Recording.hpp
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace ra::input {
+
+/**
+ * Everything the game reads from input during a single frame, plus the frame's time step.
+ */
+struct FrameInput {
+  float    dt{0.0f};
+  uint16_t cursor_x{0U};
+  uint16_t cursor_y{0U};
+  uint8_t  keys{0U};           // Bit per Key
+  uint8_t  mouse_buttons{0U};  // Bit per MouseButton
+  uint8_t  cursor_valid{0U};   // Whether the cursor was inside the window
+  uint8_t  reserved{0U};
+};
+
+static_assert(sizeof(FrameInput) == 12U, "FrameInput is written to recordings as is");
+
+/**
+ * Input of a whole run along with the seed of the main thread's random generator, which is enough to reproduce the
+ * exact same simulation.
+ *
+ * File format (native endianness): "RAIN", uint32_t version, uint64_t seed, uint32_t frames count, FrameInput frames[].
+ */
+struct Recording {
+  uint64_t                seed{0U};
+  std::vector<FrameInput> frames;
+};
+
+/**
+ * @return Current state of the input devices read through CheckKey, CheckMouseButton and GetCursorPosition.
+ */
+[[nodiscard]] FrameInput CaptureFrameInput(float dt);
+
+/**
+ * While set, CheckKey, CheckMouseButton and GetCursorPosition return the state from `frame` instead of the actual
+ * devices. Pass nullptr to read the devices again.
+ */
+void SetPlaybackFrame(const FrameInput* frame);
+
+[[nodiscard]] const FrameInput* GetPlaybackFrame();
+
+bool SaveRecording(const std::filesystem::path& filepath, const Recording& recording);
+[[nodiscard]] std::optional<Recording> LoadRecording(const std::filesystem::path& filepath);
+
+}  // namespace ra::input
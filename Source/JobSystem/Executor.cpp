@@ -8,6 +8,7 @@
 
 #include <JobSystem/Executor.hpp>
 
+#include <Profile/Profiler.hpp>
 #include <Utils/Assert.hpp>
 
 namespace ra::job {
@@ -15,9 +16,12 @@ namespace ra::job {
 static thread_local Executor* current_job_system;
 
 Executor::Executor(size_t thread_count) {
+  jobs_.Reserve(kReservedJobs);
+
   for (size_t i = 0; i < thread_count; ++i) {
     threads_.emplace_back([this]() {
       current_job_system = this;
+      RA_PROFILE_THREAD("Executor worker");
 
       while (stopped_.load() == 0) {
         auto job = jobs_.Pop();
@@ -26,7 +30,10 @@ Executor::Executor(size_t thread_count) {
           break;
         }
 
-        job.value()();
+        {
+          RA_PROFILE_SCOPE("Executor::Job");
+          job.value()();
+        }
 
         std::lock_guard lock(mutex_);
         jobs_left_.fetch_sub(1);
@@ -52,6 +59,8 @@ void Executor::Submit(Job job) {
 }
 
 void Executor::WaitIdle() {
+  RA_PROFILE_SCOPE("Executor::WaitIdle");
+
   std::unique_lock lock(mutex_);
 
   while (jobs_left_.load() > 0) {
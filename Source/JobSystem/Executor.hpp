@@ -9,8 +9,8 @@
 #pragma once
 
 #include <Utils/BlockingQueue.hpp>
+#include <Utils/InplaceFunction.hpp>
 
-#include <functional>
 #include <thread>
 #include <vector>
 
@@ -18,7 +18,13 @@ namespace ra::job {
 
 class Executor {
  public:
-  using Job = std::function<void()>;
+  /* Jobs are submitted every frame, so they are stored inline and never allocate */
+  static constexpr size_t kJobCapacity = 64U;
+
+  using Job = utils::InplaceFunction<void(), kJobCapacity>;
+
+  /* Jobs queued at once before the queue first grows */
+  static constexpr size_t kReservedJobs = 1024U;
 
   explicit Executor(size_t thread_count = std::thread::hardware_concurrency());
   ~Executor();
@@ -0,0 +1,109 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file FastTrig.hpp
+ * @date 2024-08-11
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+
+namespace ra::math {
+
+/**
+ * Polynomial sin/cos approximations, absolute error is below 1e-5 for |x| < 1e5 (see ra-benchmark-trig for the
+ * report against libm). Branch-free, so that the batch versions vectorize.
+ */
+inline float FastSin(float x);
+inline float FastCos(float x);
+
+/**
+ * Batch versions, `x` and the results must not alias.
+ */
+inline void FastSin(const float* __restrict x, float* __restrict sin, size_t count);
+inline void FastSinCos(const float* __restrict x, float* __restrict sin, float* __restrict cos, size_t count);
+
+namespace detail {
+
+constexpr float kHalfPi     = 0.5f * std::numbers::pi_v<float>;
+constexpr float kInvPi      = std::numbers::inv_pi_v<float>;
+constexpr float kPiHigh     = 3.140625f;  // Exactly representable with few mantissa bits, so k * kPiHigh is exact
+constexpr float kPiLow      = 9.67653589793e-4f;
+constexpr float kRoundMagic = 12582912.0f;  // 1.5 * 2^23, adding and subtracting it rounds to the nearest integer
+
+constexpr size_t kBatchBlockSize = 8U;
+
+inline float Round(float x) {
+  return (x + kRoundMagic) - kRoundMagic;
+}
+
+/* (-1)^k for an integral k */
+inline float AlternatingSign(float k) {
+  return 1.0f - 4.0f * std::abs(0.5f * k - Round(0.5f * k));
+}
+
+/* Taylor series up to r^9, the truncation error is below 4e-6 on [-pi/2, pi/2] */
+inline float SinPolynomial(float r) {
+  const float r2 = r * r;
+  return r * (1.0f + r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f + r2 * (1.0f / 362880.0f)))));
+}
+
+inline float Sin(float x) {
+  /* x = k * pi + r, r in [-pi/2, pi/2] and sin(x) = (-1)^k * sin(r) */
+  const float k = Round(x * kInvPi);
+  const float r = (x - k * kPiHigh) - k * kPiLow;
+
+  return AlternatingSign(k) * SinPolynomial(r);
+}
+
+inline float Cos(float x) {
+  /* x = (k + 1/2) * pi + r, r in [-pi/2, pi/2] and cos(x) = -(-1)^k * sin(r). Half pi is subtracted after the
+   * reduction, adding it to a large x first would lose precision. */
+  const float k = Round(x * kInvPi - 0.5f);
+  const float r = ((x - k * kPiHigh) - k * kPiLow) - kHalfPi;
+
+  return -AlternatingSign(k) * SinPolynomial(r);
+}
+
+}  // namespace detail
+
+inline float FastSin(float x) {
+  return detail::Sin(x);
+}
+
+inline float FastCos(float x) {
+  return detail::Cos(x);
+}
+
+inline void FastSin(const float* __restrict x, float* __restrict sin, size_t count) {
+  /* Trip count is a multiple of the block size, so that loops vectorize without an epilogue even at -O2 */
+  const size_t vectorized = count / detail::kBatchBlockSize * detail::kBatchBlockSize;
+
+  for (size_t i = 0U; i < vectorized; ++i) {
+    sin[i] = detail::Sin(x[i]);
+  }
+
+  for (size_t i = vectorized; i < count; ++i) {
+    sin[i] = detail::Sin(x[i]);
+  }
+}
+
+inline void FastSinCos(const float* __restrict x, float* __restrict sin, float* __restrict cos, size_t count) {
+  FastSin(x, sin, count);
+
+  const size_t vectorized = count / detail::kBatchBlockSize * detail::kBatchBlockSize;
+
+  for (size_t i = 0U; i < vectorized; ++i) {
+    cos[i] = detail::Cos(x[i]);
+  }
+
+  for (size_t i = vectorized; i < count; ++i) {
+    cos[i] = detail::Cos(x[i]);
+  }
+}
+
+}  // namespace ra::math
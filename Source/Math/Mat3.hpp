@@ -148,7 +148,7 @@ inline constexpr Mat3<T> Identity(T diagonal = 1) {
 
   for (size_t row = 0U; row < 3U; row++) {
     for (size_t col = 0U; col < 3U; col++) {
-      matrix[row][col] = diagonal;
+      matrix[row][col] = (row == col) ? diagonal : 0;
     }
   }
 
@@ -0,0 +1,284 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file AllocationTracker.cpp
+ * @date 2024-08-23
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/AllocationTracker.hpp>
+
+#include <Utils/Log.hpp>
+
+#if defined(RA_TRACK_ALLOCATIONS)
+#include <cxxabi.h>
+#include <execinfo.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+#endif
+
+namespace ra::profile {
+
+#if defined(RA_TRACK_ALLOCATIONS)
+
+namespace {
+
+/* Record and operator new themselves */
+constexpr size_t kSkippedFrames = 2U;
+
+struct CallSite {
+  std::array<void*, AllocationTracker::kMaxDepth> frames{};
+  size_t                                          depth{0U};
+  uint64_t                                        hash{0U};
+  uint64_t                                        allocations{0U};
+  uint64_t                                        bytes{0U};
+};
+
+std::atomic<uint64_t> g_allocations{0U};
+std::atomic<uint64_t> g_bytes{0U};
+std::atomic<uint64_t> g_deallocations{0U};
+std::atomic<bool>     g_capture{false};
+
+/* Open addressing table, filled under the mutex without allocating */
+std::mutex                                              g_call_sites_mutex;
+std::array<CallSite, AllocationTracker::kMaxCallSites> g_call_sites;
+uint64_t                                                g_dropped_allocations{0U};
+
+/* Set while the tracker itself runs, so that allocations of backtrace() and of reporting aren't recorded */
+thread_local bool t_inside_tracker{false};
+
+void RecordCallSite(size_t size) {
+  std::array<void*, AllocationTracker::kMaxDepth + kSkippedFrames> frames;
+  const int captured = backtrace(frames.data(), static_cast<int>(frames.size()));
+  if (captured <= static_cast<int>(kSkippedFrames)) {
+    return;
+  }
+
+  const size_t depth = static_cast<size_t>(captured) - kSkippedFrames;
+  void** const first = frames.data() + kSkippedFrames;
+
+  /* FNV-1a over the return addresses */
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0U; i < depth; ++i) {
+    hash = (hash ^ reinterpret_cast<uintptr_t>(first[i])) * 1099511628211ULL;
+  }
+
+  std::lock_guard lock(g_call_sites_mutex);
+
+  for (size_t probe = 0U; probe < g_call_sites.size(); ++probe) {
+    auto& call_site = g_call_sites[(hash + probe) % g_call_sites.size()];
+
+    if (call_site.allocations == 0U) {
+      std::copy_n(first, depth, call_site.frames.begin());
+      call_site.depth = depth;
+      call_site.hash  = hash;
+    } else if (call_site.hash != hash || call_site.depth != depth ||
+               !std::equal(first, first + depth, call_site.frames.begin())) {
+      continue;
+    }
+
+    ++call_site.allocations;
+    call_site.bytes += size;
+    return;
+  }
+
+  ++g_dropped_allocations;
+}
+
+void Record(size_t size) {
+  if (t_inside_tracker) {
+    return;
+  }
+
+  g_allocations.fetch_add(1U, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (g_capture.load(std::memory_order_relaxed)) {
+    t_inside_tracker = true;
+    RecordCallSite(size);
+    t_inside_tracker = false;
+  }
+}
+
+/* Demangles the symbol of a backtrace_symbols line, "binary(symbol+offset) [address]" on Linux */
+std::string Symbolize(const char* line) {
+  const char* begin = std::strchr(line, '(');
+  const char* end   = (begin != nullptr) ? std::strchr(begin, '+') : nullptr;
+
+  if (begin == nullptr || end == nullptr || end == begin + 1) {
+    return line;
+  }
+
+  const std::string mangled(begin + 1, end);
+
+  int   status    = 0;
+  char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+  if (status != 0 || demangled == nullptr) {
+    return line;
+  }
+
+  std::string symbol = demangled;
+  std::free(demangled);
+
+  return symbol;
+}
+
+}  // namespace
+
+bool AllocationTracker::Enabled() {
+  return true;
+}
+
+AllocationCounts AllocationTracker::Counts() {
+  return {.allocations   = g_allocations.load(std::memory_order_relaxed),
+          .bytes         = g_bytes.load(std::memory_order_relaxed),
+          .deallocations = g_deallocations.load(std::memory_order_relaxed)};
+}
+
+void AllocationTracker::CaptureCallSites(bool capture) {
+  if (capture) {
+    /* The first backtrace loads the unwinder, which allocates */
+    t_inside_tracker = true;
+    void* frame      = nullptr;
+    backtrace(&frame, 1);
+    t_inside_tracker = false;
+  }
+
+  g_capture.store(capture, std::memory_order_relaxed);
+}
+
+void AllocationTracker::PrintCallSites(size_t max_call_sites) {
+  t_inside_tracker = true;
+
+  std::vector<CallSite> call_sites;
+  uint64_t              dropped = 0U;
+  {
+    std::lock_guard lock(g_call_sites_mutex);
+
+    for (auto& call_site : g_call_sites) {
+      if (call_site.allocations > 0U) {
+        call_sites.push_back(call_site);
+        call_site = CallSite{};
+      }
+    }
+
+    dropped               = g_dropped_allocations;
+    g_dropped_allocations = 0U;
+  }
+
+  std::sort(call_sites.begin(), call_sites.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.allocations > rhs.allocations; });
+
+  RA_LOG_INFO("%zu allocation call sites captured (%llu allocations dropped), top %zu:", call_sites.size(),
+              static_cast<unsigned long long>(dropped), std::min(max_call_sites, call_sites.size()));
+
+  for (size_t i = 0U; i < std::min(max_call_sites, call_sites.size()); ++i) {
+    const auto& call_site = call_sites[i];
+    std::printf("#%zu: %llu allocations, %llu bytes\n", i, static_cast<unsigned long long>(call_site.allocations),
+                static_cast<unsigned long long>(call_site.bytes));
+
+    char** symbols = backtrace_symbols(call_site.frames.data(), static_cast<int>(call_site.depth));
+    for (size_t frame = 0U; frame < call_site.depth; ++frame) {
+      std::printf("    %s\n", (symbols != nullptr) ? Symbolize(symbols[frame]).c_str() : "?");
+    }
+    std::free(symbols);
+  }
+
+  t_inside_tracker = false;
+}
+
+#else
+
+bool AllocationTracker::Enabled() {
+  return false;
+}
+
+AllocationCounts AllocationTracker::Counts() {
+  return {};
+}
+
+void AllocationTracker::CaptureCallSites(bool) {}
+
+void AllocationTracker::PrintCallSites(size_t) {
+  RA_LOG_WARN("Built without RA_TRACK_ALLOCATIONS, no allocations are tracked");
+}
+
+#endif
+
+}  // namespace ra::profile
+
+#if defined(RA_TRACK_ALLOCATIONS)
+
+/* Replacements of the global allocation functions, all of them end up in Allocate and Deallocate */
+namespace {
+
+void* Allocate(size_t size, size_t alignment) {
+  ra::profile::Record(size);
+
+  void* memory = nullptr;
+  if (alignment <= alignof(std::max_align_t)) {
+    memory = std::malloc(std::max<size_t>(size, 1U));
+  } else if (posix_memalign(&memory, alignment, std::max<size_t>(size, 1U)) != 0) {
+    memory = nullptr;
+  }
+
+  return memory;
+}
+
+void* AllocateOrThrow(size_t size, size_t alignment) {
+  void* memory = Allocate(size, alignment);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return memory;
+}
+
+void Deallocate(void* memory) {
+  if (memory != nullptr) {
+    ra::profile::g_deallocations.fetch_add(1U, std::memory_order_relaxed);
+    std::free(memory);
+  }
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, size_t(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, size_t(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return Allocate(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return Allocate(size, size_t(alignment));
+}
+
+void operator delete(void* memory) noexcept { Deallocate(memory); }
+void operator delete[](void* memory) noexcept { Deallocate(memory); }
+void operator delete(void* memory, size_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, size_t) noexcept { Deallocate(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Deallocate(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { Deallocate(memory); }
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file AllocationTracker.hpp
+ * @date 2024-08-23
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ra::profile {
+
+/* Heap operations of all threads since the start */
+struct AllocationCounts {
+  uint64_t allocations{0U};
+  uint64_t bytes{0U};
+  uint64_t deallocations{0U};
+};
+
+/**
+ * In builds with RA_TRACK_ALLOCATIONS the global operator new and delete are replaced with ones counting every heap
+ * allocation of every thread, so that allocations per frame are known (see `--check-allocations` of the headless game).
+ *
+ * While call site capture is on, each allocation also takes a backtrace, and allocations are aggregated per distinct
+ * backtrace. That is slow, so it's meant to be turned on only for the frames being investigated. Without
+ * RA_TRACK_ALLOCATIONS nothing is counted.
+ */
+class AllocationTracker {
+ public:
+  static constexpr size_t kMaxCallSites = 1024U;  // Distinct backtraces, allocations from new ones past it are dropped
+  static constexpr size_t kMaxDepth     = 12U;    // Frames per backtrace
+
+  [[nodiscard]] static bool             Enabled();
+  [[nodiscard]] static AllocationCounts Counts();
+
+  static void CaptureCallSites(bool capture);
+
+  /* Logs the call sites with the most allocations, symbolized, and forgets all captured call sites */
+  static void PrintCallSites(size_t max_call_sites = 10U);
+};
+
+}  // namespace ra::profile
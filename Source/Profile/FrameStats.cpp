@@ -0,0 +1,124 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file FrameStats.cpp
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/FrameStats.hpp>
+
+#include <Profile/Profiler.hpp>
+#include <Utils/Log.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace ra::profile {
+
+FrameStats& FrameStats::Instance() {
+  static FrameStats stats;
+  return stats;
+}
+
+void FrameStats::SetBudget(uint64_t budget_ns) {
+  budget_ns_ = budget_ns;
+}
+
+uint64_t FrameStats::Budget() const {
+  return budget_ns_;
+}
+
+void FrameStats::BeginFrame() {
+  const uint64_t now = NowNs();
+
+  if (frame_start_ns_ == 0U) {
+    run_start_ns_    = now;
+    window_start_ns_ = now;
+  } else {
+    Record(FrameStage::Frame, now - frame_start_ns_);
+  }
+
+  frame_start_ns_ = now;
+
+  if (now - window_start_ns_ >= kReportWindowNs) {
+    Report(window_, "last", (now - window_start_ns_) * 1e-9);
+
+    for (auto& histogram : window_.stages) {
+      histogram.Reset();
+    }
+    window_.hitches.store(0U, std::memory_order_relaxed);
+
+    window_start_ns_ = now;
+  }
+}
+
+void FrameStats::Record(FrameStage stage, uint64_t duration_ns) {
+  for (auto* window : {&total_, &window_}) {
+    window->stages[static_cast<size_t>(stage)].Record(duration_ns);
+
+    if (stage == FrameStage::Frame && duration_ns > kHitchBudgetFactor * budget_ns_) {
+      window->hitches.fetch_add(1U, std::memory_order_relaxed);
+    }
+  }
+}
+
+void FrameStats::ReportTotal() const {
+  Report(total_, "whole run", (frame_start_ns_ - run_start_ns_) * 1e-9);
+}
+
+void FrameStats::Report(const Window& window, const char* title, double seconds) const {
+  const auto& frame = window.stages[static_cast<size_t>(FrameStage::Frame)];
+
+  RA_LOG_INFO("Frame times of the %s (%.1f s): %llu frames, %llu hitches over %.2f ms", title, seconds,
+              static_cast<unsigned long long>(frame.Count()),
+              static_cast<unsigned long long>(window.hitches.load(std::memory_order_relaxed)),
+              kHitchBudgetFactor * budget_ns_ * 1e-6);
+
+  std::printf("%-8s %10s %10s %10s %10s %10s\n", "ms", "mean", "p50", "p95", "p99", "max");
+  for (size_t stage = 0U; stage < window.stages.size(); ++stage) {
+    const auto& histogram = window.stages[stage];
+
+    std::printf("%-8s %10.3f %10.3f %10.3f %10.3f %10.3f\n", ToString(static_cast<FrameStage>(stage)),
+                histogram.Mean() * 1e-6, histogram.Percentile(0.50) * 1e-6, histogram.Percentile(0.95) * 1e-6,
+                histogram.Percentile(0.99) * 1e-6, histogram.Max() * 1e-6);
+  }
+}
+
+bool FrameStats::WriteJson(const std::filesystem::path& filepath) const {
+  std::ofstream fs(filepath, std::ios::out);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  char line[256];
+  std::snprintf(line, sizeof(line), "{\n  \"budget_ms\": %.4f,\n  \"hitch_threshold_ms\": %.4f,\n  \"hitches\": %llu",
+                budget_ns_ * 1e-6, kHitchBudgetFactor * budget_ns_ * 1e-6,
+                static_cast<unsigned long long>(total_.hitches.load(std::memory_order_relaxed)));
+  fs << line;
+
+  for (size_t stage = 0U; stage < total_.stages.size(); ++stage) {
+    const auto& histogram = total_.stages[stage];
+
+    std::snprintf(line, sizeof(line),
+                  ",\n  \"%s\": {\"count\": %llu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, "
+                  "\"p99_ms\": %.4f, \"max_ms\": %.4f}",
+                  ToString(static_cast<FrameStage>(stage)), static_cast<unsigned long long>(histogram.Count()),
+                  histogram.Mean() * 1e-6, histogram.Percentile(0.50) * 1e-6, histogram.Percentile(0.95) * 1e-6,
+                  histogram.Percentile(0.99) * 1e-6, histogram.Max() * 1e-6);
+    fs << line;
+  }
+
+  fs << "\n}\n";
+
+  if (!fs) {
+    RA_LOG_ERROR("Failed to write frame stats \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  RA_LOG_INFO("Saved frame stats \"%s\"", filepath.c_str());
+  return true;
+}
+
+}  // namespace ra::profile
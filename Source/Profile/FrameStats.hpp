@@ -0,0 +1,89 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file FrameStats.hpp
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <Profile/Histogram.hpp>
+
+#include <filesystem>
+
+namespace ra::profile {
+
+enum class FrameStage : uint32_t {
+  Frame,
+  Update,
+  Render,
+
+  Count
+};
+
+constexpr const char* ToString(FrameStage stage) {
+  switch (stage) {
+    case FrameStage::Frame:  { return "frame"; }
+    case FrameStage::Update: { return "update"; }
+    case FrameStage::Render: { return "render"; }
+
+    default:                 { return "invalid"; }
+  }
+}
+
+/**
+ * Distributions of frame, update and render times, both over the whole run and over report windows of
+ * kReportWindowNs, which are logged as p50/p95/p99/max. Frames longer than twice the budget are counted as hitches.
+ *
+ * Unlike the profiler, it is always enabled, recording only costs a few atomic increments per frame.
+ */
+class FrameStats {
+ public:
+  static constexpr uint64_t kDefaultBudgetNs   = 16'666'667U;
+  static constexpr uint64_t kHitchBudgetFactor = 2U;
+  static constexpr uint64_t kReportWindowNs    = 10'000'000'000U;
+
+  static FrameStats& Instance();
+
+  /* Target frame time, hitches are frames longer than kHitchBudgetFactor budgets */
+  void                   SetBudget(uint64_t budget_ns);
+  [[nodiscard]] uint64_t Budget() const;
+
+  /**
+   * Marks the start of a frame, recording the duration of the previous one. Logs the window's statistics once
+   * kReportWindowNs has passed.
+   */
+  void BeginFrame();
+
+  /* Records the duration of a part of the current frame */
+  void Record(FrameStage stage, uint64_t duration_ns);
+
+  /* Logs statistics of the whole run */
+  void ReportTotal() const;
+
+  /**
+   * Writes statistics of the whole run as JSON, all durations in milliseconds.
+   */
+  bool WriteJson(const std::filesystem::path& filepath) const;
+
+ private:
+  struct Window {
+    std::array<Histogram, static_cast<size_t>(FrameStage::Count)> stages;
+    std::atomic<uint64_t>                                          hitches{0U};
+  };
+
+  FrameStats() = default;
+
+  void Report(const Window& window, const char* title, double seconds) const;
+
+  uint64_t budget_ns_{kDefaultBudgetNs};
+  uint64_t run_start_ns_{0U};
+  uint64_t frame_start_ns_{0U};
+  uint64_t window_start_ns_{0U};
+
+  Window total_;
+  Window window_;
+};
+
+}  // namespace ra::profile
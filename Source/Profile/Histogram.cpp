@@ -0,0 +1,95 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Histogram.cpp
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/Histogram.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace ra::profile {
+
+size_t Histogram::BucketIndex(uint64_t value) {
+  /* Values below kSubBuckets are exact, the rest keep their kSubBucketBits most significant bits after the leading 1 */
+  if (value < kSubBuckets) {
+    return value;
+  }
+
+  const uint32_t shift = static_cast<uint32_t>(std::bit_width(value)) - 1U - kSubBucketBits;
+  return (shift + 1U) * kSubBuckets + ((value >> shift) - kSubBuckets);
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+
+  const uint64_t shift = index / kSubBuckets - 1U;
+  const uint64_t low   = (kSubBuckets + index % kSubBuckets) << shift;
+
+  return low + (uint64_t{1} << shift) - 1U;
+}
+
+void Histogram::Record(uint64_t value_ns) {
+  value_ns = std::min(value_ns, kMaxValue);
+
+  buckets_[BucketIndex(value_ns)].fetch_add(1U, std::memory_order_relaxed);
+  sum_.fetch_add(value_ns, std::memory_order_relaxed);
+
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (value_ns > max && !max_.compare_exchange_weak(max, value_ns, std::memory_order_relaxed)) {
+  }
+
+  /* Incremented last, so that a concurrent reader never sees more values counted than bucketed */
+  count_.fetch_add(1U, std::memory_order_release);
+}
+
+void Histogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0U, std::memory_order_relaxed);
+  }
+
+  count_.store(0U, std::memory_order_relaxed);
+  sum_.store(0U, std::memory_order_relaxed);
+  max_.store(0U, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::Count() const {
+  return count_.load(std::memory_order_acquire);
+}
+
+uint64_t Histogram::Max() const {
+  return max_.load(std::memory_order_relaxed);
+}
+
+double Histogram::Mean() const {
+  const uint64_t count = Count();
+  return (count == 0U) ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+}
+
+uint64_t Histogram::Percentile(double p) const {
+  const uint64_t count = Count();
+  if (count == 0U) {
+    return 0U;
+  }
+
+  const auto rank = std::max<uint64_t>(1U, static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * count)));
+
+  uint64_t seen = 0U;
+  for (size_t index = 0U; index < kBucketsCount; ++index) {
+    seen += buckets_[index].load(std::memory_order_relaxed);
+
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(index), Max());
+    }
+  }
+
+  return Max();
+}
+
+}  // namespace ra::profile
@@ -0,0 +1,58 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Histogram.hpp
+ * @date 2024-08-20
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ra::profile {
+
+/**
+ * HDR-style histogram of durations in nanoseconds. Values are bucketed by their power of two, and each power of two is
+ * split into kSubBuckets linear sub-buckets, so every value up to 2^kMaxExponent ns (about 18 minutes) is kept with
+ * a relative error below 1 / kSubBuckets, in a fixed amount of memory.
+ *
+ * Recording is a couple of relaxed atomic operations, so it is lock-free and allocation-free and can be done from any
+ * thread while another one reads the percentiles. Reset is not atomic with respect to concurrent recording.
+ */
+class Histogram {
+ public:
+  static constexpr uint32_t kSubBucketBits = 5U;
+  static constexpr uint64_t kSubBuckets    = 1U << kSubBucketBits;
+  static constexpr uint32_t kMaxExponent   = 40U;
+  static constexpr uint64_t kMaxValue      = (uint64_t{1} << kMaxExponent) - 1U;
+  static constexpr size_t   kBucketsCount  = (kMaxExponent - kSubBucketBits + 1U) * kSubBuckets;
+
+  /* Values above kMaxValue are clamped */
+  void Record(uint64_t value_ns);
+
+  void Reset();
+
+  [[nodiscard]] uint64_t Count() const;
+  [[nodiscard]] uint64_t Max() const;
+  [[nodiscard]] double   Mean() const;
+
+  /**
+   * Smallest value such that at least `p` (in [0, 1]) of the recorded values are not greater than it, up to the
+   * histogram's precision. Returns 0 if nothing has been recorded.
+   */
+  [[nodiscard]] uint64_t Percentile(double p) const;
+
+ private:
+  [[nodiscard]] static size_t   BucketIndex(uint64_t value);
+  [[nodiscard]] static uint64_t BucketUpperBound(size_t index);
+
+  std::array<std::atomic<uint64_t>, kBucketsCount> buckets_{};
+  std::atomic<uint64_t>                            count_{0U};
+  std::atomic<uint64_t>                            sum_{0U};
+  std::atomic<uint64_t>                            max_{0U};
+};
+
+}  // namespace ra::profile
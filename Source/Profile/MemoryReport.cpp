@@ -0,0 +1,96 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file MemoryReport.cpp
+ * @date 2024-08-22
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/MemoryReport.hpp>
+
+#include <Utils/Log.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace ra::profile {
+
+void MemoryReport::Add(MemoryEntry entry) {
+  entries_.push_back(std::move(entry));
+}
+
+const std::vector<MemoryEntry>& MemoryReport::Entries() const {
+  return entries_;
+}
+
+void MemoryReport::Print() const {
+  RA_LOG_INFO("Memory report (%zu entries)", entries_.size());
+  std::printf("%-10s %10s %10s %12s %14s  %s\n", "category", "count", "capacity", "used, KiB", "reserved, KiB", "name");
+
+  const char* category       = nullptr;
+  size_t      category_used  = 0U;
+  size_t      category_total = 0U;
+
+  const auto print_total = [&]() {
+    if (category != nullptr) {
+      std::printf("%-10s %10s %10s %12.1f %14.1f  %s\n", category, "", "", category_used / 1024.0,
+                  category_total / 1024.0, "total");
+    }
+  };
+
+  /* Entries are added category by category, so groups are contiguous */
+  for (const auto& entry : entries_) {
+    if (category == nullptr || std::strcmp(category, entry.category) != 0) {
+      print_total();
+
+      category       = entry.category;
+      category_used  = 0U;
+      category_total = 0U;
+    }
+
+    category_used  += entry.used_bytes;
+    category_total += entry.reserved_bytes;
+
+    std::printf("%-10s %10zu %10zu %12.1f %14.1f  %s\n", entry.category, entry.count, entry.capacity,
+                entry.used_bytes / 1024.0, entry.reserved_bytes / 1024.0, entry.name.c_str());
+  }
+
+  print_total();
+}
+
+bool MemoryReport::WriteJson(const std::filesystem::path& filepath) const {
+  std::ofstream fs(filepath, std::ios::out);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  /* Names are type names and fixed labels, which never need escaping */
+  char line[512];
+  fs << "{\"entries\": [\n";
+
+  for (size_t i = 0U; i < entries_.size(); ++i) {
+    const auto& entry = entries_[i];
+
+    std::snprintf(line, sizeof(line),
+                  "  {\"category\": \"%s\", \"name\": \"%s\", \"count\": %zu, \"capacity\": %zu, \"used_bytes\": %zu, "
+                  "\"reserved_bytes\": %zu}%s\n",
+                  entry.category, entry.name.c_str(), entry.count, entry.capacity, entry.used_bytes,
+                  entry.reserved_bytes, (i + 1U < entries_.size()) ? "," : "");
+    fs << line;
+  }
+
+  fs << "]}\n";
+
+  if (!fs) {
+    RA_LOG_ERROR("Failed to write memory report \"%s\"", filepath.c_str());
+    return false;
+  }
+
+  RA_LOG_INFO("Saved memory report \"%s\"", filepath.c_str());
+  return true;
+}
+
+}  // namespace ra::profile
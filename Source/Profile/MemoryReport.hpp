@@ -0,0 +1,64 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file MemoryReport.hpp
+ * @date 2024-08-22
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ra::profile {
+
+/**
+ * Heap memory held by one object or a group of them. `count` and `capacity` are in the object's own units (rows,
+ * particles, pixels, map entries), `used_bytes` is what live elements take and `reserved_bytes` is what is allocated.
+ */
+struct MemoryEntry {
+  const char* category{""};
+  std::string name;
+  size_t      count{0U};
+  size_t      capacity{0U};
+  size_t      used_bytes{0U};
+  size_t      reserved_bytes{0U};
+};
+
+/**
+ * Snapshot of memory usage, filled by subsystems' ReportMemory. Entries of different categories may overlap (e.g.
+ * per component type and per archetype), so totals are only meaningful per category.
+ */
+class MemoryReport {
+ public:
+  void Add(MemoryEntry entry);
+
+  [[nodiscard]] const std::vector<MemoryEntry>& Entries() const;
+
+  /* Logs all entries as a table, grouped by category */
+  void Print() const;
+
+  bool WriteJson(const std::filesystem::path& filepath) const;
+
+ private:
+  std::vector<MemoryEntry> entries_;
+};
+
+template <typename T>
+[[nodiscard]] size_t VectorBytes(const std::vector<T>& vector) {
+  return vector.capacity() * sizeof(T);
+}
+
+/**
+ * Estimate of an unordered map's (or set's) heap memory: the bucket array plus a node per element, which holds the
+ * value, a pointer to the next node and a cached hash. Values' own allocations are not included.
+ */
+template <typename Map>
+[[nodiscard]] size_t HashMapBytes(const Map& map) {
+  return map.bucket_count() * sizeof(void*) + map.size() * (sizeof(typename Map::value_type) + 2U * sizeof(void*));
+}
+
+}  // namespace ra::profile
@@ -0,0 +1,161 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file PerfCounters.cpp
+ * @date 2024-08-21
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/PerfCounters.hpp>
+
+#include <Utils/Log.hpp>
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace ra::profile {
+
+PerfCounters& PerfCounters::ForCurrentThread() {
+  thread_local PerfCounters counters;
+  return counters;
+}
+
+bool PerfCounters::Available(PerfCounter counter) const {
+  return fds_[static_cast<size_t>(counter)] >= 0;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+struct CounterConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t CacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8U) | (result << 16U);
+}
+
+constexpr CounterConfig kCounterConfigs[kPerfCountersCount] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE,
+   CacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int OpenCounter(const CounterConfig& config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+
+  attr.size           = sizeof(attr);
+  attr.type           = config.type;
+  attr.config         = config.config;
+  attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.disabled       = (group_fd == -1) ? 1U : 0U;  // The whole group is enabled through its leader
+  attr.exclude_kernel = 1U;
+  attr.exclude_hv     = 1U;
+
+  /* Calling thread only, on any CPU */
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0UL));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+
+  for (size_t counter = 0U; counter < kPerfCountersCount; ++counter) {
+    const int fd = OpenCounter(kCounterConfigs[counter], group_fd_);
+    if (fd < 0) {
+      static std::atomic<bool> warned{false};
+      if (!warned.exchange(true)) {
+        RA_LOG_WARN("Hardware counter \"%s\" is unavailable (%s), it reads as zero",
+                    ToString(static_cast<PerfCounter>(counter)), std::strerror(errno));
+      }
+      continue;
+    }
+
+    if (group_fd_ == -1) {
+      group_fd_ = fd;
+    }
+
+    fds_[counter]                 = fd;
+    read_order_[opened_count_++] = static_cast<PerfCounter>(counter);
+  }
+
+  if (group_fd_ != -1) {
+    ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+PerfCounterSample PerfCounters::Read() const {
+  PerfCounterSample sample{};
+  if (group_fd_ == -1) {
+    return sample;
+  }
+
+  /* Group layout: number of counters, time enabled, time running, then the values in the order they were opened */
+  constexpr size_t kHeaderSize = 3U;
+
+  uint64_t buffer[kHeaderSize + kPerfCountersCount];
+  if (read(group_fd_, buffer, sizeof(buffer)) <
+      static_cast<ssize_t>(sizeof(uint64_t) * (kHeaderSize + opened_count_))) {
+    return sample;
+  }
+
+  sample.time_enabled_ns = buffer[1U];
+  sample.time_running_ns = buffer[2U];
+
+  /* The group was never scheduled, there is nothing to scale */
+  if (sample.time_running_ns == 0U) {
+    return sample;
+  }
+
+  const double scale = static_cast<double>(sample.time_enabled_ns) / static_cast<double>(sample.time_running_ns);
+  for (uint32_t i = 0U; i < opened_count_; ++i) {
+    const uint64_t value = buffer[kHeaderSize + i];
+
+    sample.values[static_cast<size_t>(read_order_[i])] =
+        (sample.time_running_ns < sample.time_enabled_ns) ? static_cast<uint64_t>(static_cast<double>(value) * scale)
+                                                          : value;
+  }
+
+  return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+PerfCounterSample PerfCounters::Read() const {
+  return {};
+}
+
+#endif
+
+}  // namespace ra::profile
@@ -0,0 +1,85 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file PerfCounters.hpp
+ * @date 2024-08-21
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ra::profile {
+
+enum class PerfCounter : uint32_t {
+  Cycles,
+  Instructions,
+  L1DMisses,
+  LLCMisses,
+  BranchMisses,
+
+  Count
+};
+
+constexpr const char* ToString(PerfCounter counter) {
+  switch (counter) {
+    case PerfCounter::Cycles:       { return "cycles"; }
+    case PerfCounter::Instructions: { return "instructions"; }
+    case PerfCounter::L1DMisses:    { return "L1D misses"; }
+    case PerfCounter::LLCMisses:    { return "LLC misses"; }
+    case PerfCounter::BranchMisses: { return "branch misses"; }
+
+    default:                        { return "invalid"; }
+  }
+}
+
+constexpr size_t kPerfCountersCount = static_cast<size_t>(PerfCounter::Count);
+
+using PerfCounterValues = std::array<uint64_t, kPerfCountersCount>;
+
+/**
+ * Counter values along with the time the group was enabled and the time it was actually counting. The two differ when
+ * the kernel multiplexes more counters than the PMU has, then the values are scaled by enabled / running and are only
+ * estimates.
+ */
+struct PerfCounterSample {
+  PerfCounterValues values{};
+  uint64_t          time_enabled_ns{0U};
+  uint64_t          time_running_ns{0U};
+};
+
+/**
+ * Hardware counters of the calling thread, opened with Linux's perf_event_open as a single group on the thread's first
+ * use, so that all of them are read at once and count over exactly the same instructions.
+ *
+ * Counters the CPU or the kernel doesn't provide (e.g. in virtual machines, or with a restrictive
+ * perf_event_paranoid) stay at zero, which is logged once. On other platforms nothing is ever available.
+ */
+class PerfCounters {
+ public:
+  static PerfCounters& ForCurrentThread();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&)            = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /* Whether the counter could be opened */
+  [[nodiscard]] bool Available(PerfCounter counter) const;
+
+  /* Values since the counters were opened, a couple of hundred nanoseconds (one system call) */
+  [[nodiscard]] PerfCounterSample Read() const;
+
+ private:
+  PerfCounters();
+
+  int                                         group_fd_{-1};
+  std::array<int, kPerfCountersCount>         fds_;
+  std::array<PerfCounter, kPerfCountersCount> read_order_{};
+  uint32_t                                    opened_count_{0U};
+};
+
+}  // namespace ra::profile
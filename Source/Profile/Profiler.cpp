@@ -0,0 +1,279 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Profiler.cpp
+ * @date 2024-08-19
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Profile/Profiler.hpp>
+
+#include <Utils/Log.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace ra::profile {
+
+ThreadBuffer::ThreadBuffer(uint32_t thread_index) : thread_index_(thread_index) {}
+
+void ThreadBuffer::Push(const Event& event) {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+
+  if (head - tail_.load(std::memory_order_acquire) == kCapacity) {
+    dropped_.fetch_add(1U, std::memory_order_relaxed);
+    return;
+  }
+
+  events_[head % kCapacity] = event;
+  head_.store(head + 1U, std::memory_order_release);
+}
+
+uint32_t ThreadBuffer::ThreadIndex() const {
+  return thread_index_;
+}
+
+uint64_t ThreadBuffer::Dropped() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+Profiler& Profiler::Instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+ThreadBuffer& Profiler::CurrentThreadBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+
+  if (buffer == nullptr) {
+    std::lock_guard lock(buffers_mutex_);
+    buffer = buffers_.emplace_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(buffers_.size()))).get();
+    std::snprintf(buffer->name.data(), buffer->name.size(), "Thread %u", buffer->ThreadIndex());
+  }
+
+  return *buffer;
+}
+
+void Profiler::Record(const Event& event) {
+  CurrentThreadBuffer().Push(event);
+}
+
+void Profiler::Collect() {
+  const uint64_t now = NowNs();
+  if (window_start_ns_ == 0U) {
+    window_start_ns_ = now;
+  }
+
+  if (trace_requested_.exchange(false, std::memory_order_relaxed) && trace_frames_left_ == 0U) {
+    CaptureTrace("trace.json");
+  }
+
+  const bool tracing = (trace_frames_left_ > 0U);
+
+  {
+    std::lock_guard lock(buffers_mutex_);
+
+    for (auto& buffer : buffers_) {
+      buffer->Drain([&](const Event& event) {
+        window_durations_[event.name].push_back(event.end_ns - event.start_ns);
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+        auto& counters = window_counters_[event.name];
+        for (size_t counter = 0U; counter < kPerfCountersCount; ++counter) {
+          counters[counter] += event.counters[counter];
+        }
+
+        window_estimated_[event.name] |= event.estimated;
+#endif
+
+        if (tracing) {
+          trace_events_.push_back(TraceEvent{.event = event, .thread_index = buffer->ThreadIndex()});
+        }
+      });
+    }
+  }
+
+  if (tracing && --trace_frames_left_ == 0U) {
+    WriteTrace();
+  }
+
+  if (now - window_start_ns_ >= kReportWindowNs) {
+    Report(now - window_start_ns_);
+    window_start_ns_ = now;
+  }
+}
+
+void Profiler::SetThreadName(std::string_view name) {
+  auto& buffer = CurrentThreadBuffer();
+
+  std::lock_guard lock(buffers_mutex_);
+  std::snprintf(buffer.name.data(), buffer.name.size(), "%.*s", static_cast<int>(name.size()), name.data());
+}
+
+void Profiler::CaptureTrace(std::filesystem::path filepath, uint32_t frames) {
+  RA_LOG_INFO("Capturing a trace of %u frames into \"%s\"...", frames, filepath.c_str());
+
+  trace_path_        = std::move(filepath);
+  trace_frames_left_ = frames;
+  trace_events_.clear();
+}
+
+void Profiler::RequestTrace() {
+  trace_requested_.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::Flush() {
+  Collect();
+
+  const bool empty = std::all_of(window_durations_.begin(), window_durations_.end(),
+                                 [](const auto& scope) { return scope.second.empty(); });
+  if (empty) {
+    return;
+  }
+
+  const uint64_t now = NowNs();
+  Report(now - window_start_ns_);
+  window_start_ns_ = now;
+}
+
+const std::vector<ScopeStats>& Profiler::LastReport() const {
+  return last_report_;
+}
+
+void Profiler::Report(uint64_t window_ns) {
+  last_report_.clear();
+
+  for (auto& [name, durations] : window_durations_) {
+    if (durations.empty()) {
+      continue;
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    double sum = 0.0;
+    for (uint64_t duration : durations) {
+      sum += static_cast<double>(duration);
+    }
+
+    last_report_.push_back(ScopeStats{
+      .name   = name,
+      .count  = static_cast<uint32_t>(durations.size()),
+      .min_ns = static_cast<double>(durations.front()),
+      .avg_ns = sum / durations.size(),
+      .p99_ns = static_cast<double>(durations[std::min(durations.size() - 1U, durations.size() * 99U / 100U)])
+    });
+
+    durations.clear();
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+    last_report_.back().counters  = std::exchange(window_counters_[name], PerfCounterValues{});
+    last_report_.back().estimated = std::exchange(window_estimated_[name], false);
+#endif
+  }
+
+  std::sort(last_report_.begin(), last_report_.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+
+  uint64_t dropped = 0U;
+  {
+    std::lock_guard lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+      dropped += buffer->Dropped();
+    }
+  }
+
+  RA_LOG_INFO("Profile of the last %.2f s (%llu events dropped so far)", window_ns * 1e-9,
+              static_cast<unsigned long long>(dropped));
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  std::printf("%-28s %10s %10s %10s %10s %8s %8s %8s %8s\n", "scope, us", "count", "min", "avg", "p99", "IPC",
+              "L1D/ki", "LLC/ki", "br/ki");
+#else
+  std::printf("%-28s %10s %10s %10s %10s\n", "scope, us", "count", "min", "avg", "p99");
+#endif
+
+  for (const auto& stats : last_report_) {
+    std::printf("%-28.*s %10u %10.2f %10.2f %10.2f", static_cast<int>(stats.name.size()), stats.name.data(),
+                stats.count, stats.min_ns * 1e-3, stats.avg_ns * 1e-3, stats.p99_ns * 1e-3);
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+    /* Misses are per thousand instructions, so that scopes doing different amounts of work are comparable */
+    const auto value = [&](PerfCounter counter) {
+      return static_cast<double>(stats.counters[static_cast<size_t>(counter)]);
+    };
+
+    const double instructions = value(PerfCounter::Instructions);
+    const double cycles       = value(PerfCounter::Cycles);
+
+    if (instructions > 0.0 && cycles > 0.0) {
+      std::printf(" %8.2f %8.2f %8.2f %8.2f%s", instructions / cycles,
+                  1e3 * value(PerfCounter::L1DMisses) / instructions,
+                  1e3 * value(PerfCounter::LLCMisses) / instructions,
+                  1e3 * value(PerfCounter::BranchMisses) / instructions, stats.estimated ? " *" : "");
+    } else {
+      std::printf(" %8s %8s %8s %8s", "-", "-", "-", "-");
+    }
+#endif
+
+    std::printf("\n");
+  }
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  if (std::any_of(last_report_.begin(), last_report_.end(), [](const auto& stats) { return stats.estimated; })) {
+    std::printf("* counters were multiplexed by the kernel, values are scaled estimates\n");
+  }
+#endif
+}
+
+void Profiler::WriteTrace() {
+  std::ofstream fs(trace_path_, std::ios::out);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", trace_path_.c_str());
+    return;
+  }
+
+  uint64_t trace_start_ns = UINT64_MAX;
+  for (const auto& trace_event : trace_events_) {
+    trace_start_ns = std::min(trace_start_ns, trace_event.event.start_ns);
+  }
+
+  /* Timestamps are in microseconds, relative to the first event */
+  char line[256];
+  fs << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+  {
+    std::lock_guard lock(buffers_mutex_);
+
+    for (const auto& buffer : buffers_) {
+      std::snprintf(line, sizeof(line),
+                    "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                    "\"args\": {\"name\": \"%s\"}},\n",
+                    buffer->ThreadIndex(), buffer->name.data());
+      fs << line;
+    }
+  }
+
+  for (size_t i = 0U; i < trace_events_.size(); ++i) {
+    const auto& [event, thread_index] = trace_events_[i];
+
+    std::snprintf(line, sizeof(line),
+                  "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}%s\n",
+                  event.name, thread_index, (event.start_ns - trace_start_ns) * 1e-3,
+                  (event.end_ns - event.start_ns) * 1e-3, (i + 1U < trace_events_.size()) ? "," : "");
+    fs << line;
+  }
+
+  fs << "]}\n";
+
+  if (!fs) {
+    RA_LOG_ERROR("Failed to write trace \"%s\"", trace_path_.c_str());
+  } else {
+    RA_LOG_INFO("Saved trace \"%s\" (%zu events)", trace_path_.c_str(), trace_events_.size());
+  }
+
+  trace_events_.clear();
+  trace_events_.shrink_to_fit();
+}
+
+}  // namespace ra::profile
@@ -0,0 +1,245 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Profiler.hpp
+ * @date 2024-08-19
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <Profile/PerfCounters.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ra::profile {
+
+[[nodiscard]] inline uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * Single execution of a profiled scope. Events only keep the name's pointer, so it must be a string literal (or
+ * otherwise outlive the profiler), and scopes are aggregated by the name's contents.
+ */
+struct Event {
+  const char* name{nullptr};
+  uint64_t    start_ns{0U};
+  uint64_t    end_ns{0U};
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  PerfCounterValues counters{};        // Counted over the scope by its thread
+  bool              estimated{false};  // Counters were multiplexed during the scope, so they are scaled estimates
+#endif
+};
+
+/**
+ * Events recorded by a single thread. Only the owning thread pushes and only Profiler::Collect pops, so the ring
+ * buffer is lock-free. Events pushed while the buffer is full are dropped and counted.
+ */
+class ThreadBuffer {
+ public:
+  static constexpr size_t kCapacity = 1U << 14U;
+
+  explicit ThreadBuffer(uint32_t thread_index);
+
+  void Push(const Event& event);
+
+  template <typename Func>
+  void Drain(Func&& func);
+
+  [[nodiscard]] uint32_t ThreadIndex() const;
+  [[nodiscard]] uint64_t Dropped() const;
+
+  /* Name shown in traces, only accessed under Profiler's buffers mutex */
+  std::array<char, 32U> name{};
+
+ private:
+  std::array<Event, kCapacity> events_;
+  uint32_t                     thread_index_;
+
+  alignas(64) std::atomic<uint64_t> head_{0U};  // Written by the owning thread
+  alignas(64) std::atomic<uint64_t> tail_{0U};  // Written by Profiler::Collect
+  std::atomic<uint64_t>             dropped_{0U};
+};
+
+template <typename Func>
+void ThreadBuffer::Drain(Func&& func) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t head = head_.load(std::memory_order_acquire);
+
+  for (uint64_t i = tail; i < head; ++i) {
+    func(events_[i % kCapacity]);
+  }
+
+  tail_.store(head, std::memory_order_release);
+}
+
+/* Statistics of one scope over a report window */
+struct ScopeStats {
+  std::string_view name;
+  uint32_t         count{0U};
+  double           min_ns{0.0};
+  double           avg_ns{0.0};
+  double           p99_ns{0.0};
+
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  PerfCounterValues counters{};        // Sums over all executions
+  bool              estimated{false};  // Some of the executions were multiplexed
+#endif
+};
+
+/**
+ * Collects events of all threads and aggregates them per scope name over one second windows. At the end of each window
+ * the statistics are logged and kept as the last report. With RA_ENABLE_PERF_COUNTERS the report also has IPC and
+ * L1D, LLC and branch misses per thousand instructions of each scope (see PerfCounters), marked with '*' where the
+ * counters were multiplexed and are scaled estimates.
+ *
+ * Events of a number of frames can also be captured into a trace in the Chrome Trace Event format, which can be opened
+ * in chrome://tracing or ui.perfetto.dev, showing every thread's scopes on a shared timeline.
+ */
+class Profiler {
+ public:
+  static constexpr uint64_t kReportWindowNs     = 1'000'000'000U;
+  static constexpr uint32_t kDefaultTraceFrames = 300U;
+
+  static Profiler& Instance();
+
+  /**
+   * Records an event into the calling thread's buffer, can be called from any thread.
+   */
+  void Record(const Event& event);
+
+  /**
+   * Drains all thread buffers, must be called from a single thread, once per frame (see RA_PROFILE_FRAME).
+   */
+  void Collect();
+
+  /**
+   * Collects the remaining events and reports the current window early, unless it's empty. Called on shutdown, so that
+   * runs shorter than a window are reported as well (see RA_PROFILE_FLUSH).
+   */
+  void Flush();
+
+  [[nodiscard]] const std::vector<ScopeStats>& LastReport() const;
+
+  /**
+   * Names the calling thread in traces, `name` is copied (and truncated).
+   */
+  void SetThreadName(std::string_view name);
+
+  /**
+   * Captures events of the next `frames` frames and writes them to `filepath` as a Chrome trace.
+   */
+  void CaptureTrace(std::filesystem::path filepath, uint32_t frames = kDefaultTraceFrames);
+
+  /**
+   * Async-signal-safe request to capture kDefaultTraceFrames frames into "trace.json", starts on the next Collect.
+   */
+  void RequestTrace();
+
+ private:
+  struct TraceEvent {
+    Event    event;
+    uint32_t thread_index;
+  };
+
+  Profiler() = default;
+
+  ThreadBuffer& CurrentThreadBuffer();
+
+  void Report(uint64_t window_ns);
+  void WriteTrace();
+
+  std::mutex                                 buffers_mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;  // Never freed, threads may exit before the last Collect
+
+  uint64_t                                                    window_start_ns_{0U};
+  std::unordered_map<std::string_view, std::vector<uint64_t>> window_durations_;
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  std::unordered_map<std::string_view, PerfCounterValues> window_counters_;
+  std::unordered_map<std::string_view, bool>              window_estimated_;
+#endif
+  std::vector<ScopeStats>                                     last_report_;
+
+  std::atomic<bool>       trace_requested_{false};
+  std::filesystem::path   trace_path_;
+  uint32_t                trace_frames_left_{0U};
+  std::vector<TraceEvent> trace_events_;
+};
+
+/**
+ * Records the lifetime of the scope, see RA_PROFILE_SCOPE.
+ */
+class Scope {
+ public:
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  explicit Scope(const char* name)
+      : name_(name), start_ns_(NowNs()), start_counters_(PerfCounters::ForCurrentThread().Read()) {}
+
+  ~Scope() {
+    const PerfCounterSample end_counters = PerfCounters::ForCurrentThread().Read();
+
+    Event event{.name = name_, .start_ns = start_ns_, .end_ns = NowNs()};
+    for (size_t counter = 0U; counter < kPerfCountersCount; ++counter) {
+      event.counters[counter] = end_counters.values[counter] - start_counters_.values[counter];
+    }
+
+    event.estimated = (end_counters.time_running_ns - start_counters_.time_running_ns) <
+                      (end_counters.time_enabled_ns - start_counters_.time_enabled_ns);
+
+    Profiler::Instance().Record(event);
+  }
+#else
+  explicit Scope(const char* name) : name_(name), start_ns_(NowNs()) {}
+  ~Scope() { Profiler::Instance().Record(Event{.name = name_, .start_ns = start_ns_, .end_ns = NowNs()}); }
+#endif
+
+  Scope(const Scope&)            = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  const char* name_;
+  uint64_t    start_ns_;
+#if defined(RA_ENABLE_PERF_COUNTERS)
+  PerfCounterSample start_counters_;
+#endif
+};
+
+}  // namespace ra::profile
+
+#define RA_PROFILE_CONCAT_IMPL(first, second) first##second
+#define RA_PROFILE_CONCAT(first, second) RA_PROFILE_CONCAT_IMPL(first, second)
+
+#if defined(RA_ENABLE_PROFILING)
+
+/* Profiles the enclosing scope, `name` must be a string literal */
+#define RA_PROFILE_SCOPE(name) ::ra::profile::Scope RA_PROFILE_CONCAT(ra_profile_scope_, __LINE__)(name)
+
+/* Marks the end of a frame, collecting events recorded since the previous one */
+#define RA_PROFILE_FRAME() ::ra::profile::Profiler::Instance().Collect()
+
+/* Names the calling thread in traces */
+#define RA_PROFILE_THREAD(name) ::ra::profile::Profiler::Instance().SetThreadName(name)
+
+/* Reports the events of the last, incomplete window, e.g. on shutdown */
+#define RA_PROFILE_FLUSH() ::ra::profile::Profiler::Instance().Flush()
+
+#else
+
+#define RA_PROFILE_SCOPE(name)
+#define RA_PROFILE_FRAME()
+#define RA_PROFILE_THREAD(name)
+#define RA_PROFILE_FLUSH()
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file BlendKernels.cpp
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Render/BlendKernels.hpp>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#define RA_BLEND_SSE2_AVAILABLE
+#include <emmintrin.h>
+#endif
+
+namespace ra::render {
+
+Color PremultiplyAlpha(const math::Vec4f& normalized) {
+  return Color(static_cast<uint8_t>(normalized.r * normalized.a * 255.0f + 0.5f),
+               static_cast<uint8_t>(normalized.g * normalized.a * 255.0f + 0.5f),
+               static_cast<uint8_t>(normalized.b * normalized.a * 255.0f + 0.5f),
+               static_cast<uint8_t>(normalized.a * 255.0f + 0.5f));
+}
+
+#ifdef RA_BLEND_SSE2_AVAILABLE
+
+/* Same as MulDiv255, for 8 16-bit lanes */
+static inline __m128i MulDiv255(__m128i a, __m128i b) {
+  const __m128i t = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/* Two pixels with 16-bit channels, ARGB in memory is B, G, R, A, so alpha is the last lane of each pixel */
+static inline __m128i BroadcastAlpha(__m128i pixels) {
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* dst * (255 - src.a) / 255 for two pixels with 16-bit channels */
+static inline __m128i AttenuateDestination(__m128i dst, __m128i src) {
+  return MulDiv255(dst, _mm_sub_epi16(_mm_set1_epi16(255), BroadcastAlpha(src)));
+}
+
+static void BlendRowPremultipliedSSE2(Color* __restrict dst, const Color* __restrict src, size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U) {
+    const __m128i src_u8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i dst_u8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+    const __m128i lo = AttenuateDestination(_mm_unpacklo_epi8(dst_u8, zero), _mm_unpacklo_epi8(src_u8, zero));
+    const __m128i hi = AttenuateDestination(_mm_unpackhi_epi8(dst_u8, zero), _mm_unpackhi_epi8(src_u8, zero));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epu8(src_u8, _mm_packus_epi16(lo, hi)));
+  }
+
+  for (; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], src[i]);
+  }
+}
+
+static void BlendSpanPremultipliedSSE2(Color* __restrict dst, Color color, const uint8_t* __restrict coverage,
+                                       size_t count) {
+  const __m128i zero     = _mm_setzero_si128();
+  const __m128i color_16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int32_t>(color.Value())), zero);
+
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U) {
+    int32_t coverage_4;
+    std::memcpy(&coverage_4, coverage + i, sizeof(coverage_4));
+
+    /* c0 c1 c2 c3 -> c0 c0 c0 c0 c1 c1 c1 c1 ..., i.e. each coverage byte repeated for every channel */
+    __m128i coverage_u8 = _mm_cvtsi32_si128(coverage_4);
+    coverage_u8         = _mm_unpacklo_epi8(coverage_u8, coverage_u8);
+    coverage_u8         = _mm_unpacklo_epi16(coverage_u8, coverage_u8);
+
+    const __m128i src_lo = MulDiv255(color_16, _mm_unpacklo_epi8(coverage_u8, zero));
+    const __m128i src_hi = MulDiv255(color_16, _mm_unpackhi_epi8(coverage_u8, zero));
+
+    const __m128i dst_u8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i lo     = _mm_add_epi16(src_lo, AttenuateDestination(_mm_unpacklo_epi8(dst_u8, zero), src_lo));
+    const __m128i hi     = _mm_add_epi16(src_hi, AttenuateDestination(_mm_unpackhi_epi8(dst_u8, zero), src_hi));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+
+  for (; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], ScalePremultiplied(color, coverage[i]));
+  }
+}
+
+#endif
+
+void BlendRowPremultiplied(Color* __restrict dst, const Color* __restrict src, size_t count) {
+#ifdef RA_BLEND_SSE2_AVAILABLE
+  BlendRowPremultipliedSSE2(dst, src, count);
+#else
+  for (size_t i = 0U; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], src[i]);
+  }
+#endif
+}
+
+void BlendSpanPremultiplied(Color* __restrict dst, Color color, const uint8_t* __restrict coverage, size_t count) {
+#ifdef RA_BLEND_SSE2_AVAILABLE
+  BlendSpanPremultipliedSSE2(dst, color, coverage, count);
+#else
+  for (size_t i = 0U; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], ScalePremultiplied(color, coverage[i]));
+  }
+#endif
+}
+
+void ScaleRowPremultiplied(Color* __restrict dst, const Color* __restrict src, uint8_t opacity, size_t count) {
+  for (size_t i = 0U; i < count; ++i) {
+    dst[i] = ScalePremultiplied(src[i], opacity);
+  }
+}
+
+}  // namespace ra::render
@@ -0,0 +1,71 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file BlendKernels.hpp
+ * @date 2024-08-14
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <Render/Color.hpp>
+
+#include <cstddef>
+
+namespace ra::render {
+
+/**
+ * @return round(a * b / 255) for a, b in [0, 255], exact for all inputs without a division.
+ */
+[[nodiscard]] inline constexpr uint32_t MulDiv255(uint32_t a, uint32_t b) {
+  const uint32_t t = a * b + 128U;
+  return (t + (t >> 8U)) >> 8U;
+}
+
+/**
+ * @return Color with RGB multiplied by its alpha.
+ */
+[[nodiscard]] Color PremultiplyAlpha(const math::Vec4f& normalized);
+
+[[nodiscard]] inline constexpr Color PremultiplyAlpha(Color straight) {
+  const uint32_t a = straight.A();
+  return Color(MulDiv255(straight.R(), a), MulDiv255(straight.G(), a), MulDiv255(straight.B(), a), a);
+}
+
+/**
+ * @return Premultiplied color with all channels scaled by `coverage` / 255.
+ */
+[[nodiscard]] inline constexpr Color ScalePremultiplied(Color color, uint32_t coverage) {
+  return Color(MulDiv255(color.R(), coverage), MulDiv255(color.G(), coverage), MulDiv255(color.B(), coverage),
+               MulDiv255(color.A(), coverage));
+}
+
+/**
+ * @return Premultiplied `src` over `dst`, i.e. src + dst * (255 - src.a) / 255 per channel.
+ */
+[[nodiscard]] inline constexpr Color BlendPremultiplied(Color dst, Color src) {
+  const uint32_t inv_alpha = 255U - src.A();
+
+  /* Can't exceed 255 as long as src is properly premultiplied */
+  return Color(src.R() + MulDiv255(dst.R(), inv_alpha), src.G() + MulDiv255(dst.G(), inv_alpha),
+               src.B() + MulDiv255(dst.B(), inv_alpha), src.A() + MulDiv255(dst.A(), inv_alpha));
+}
+
+/**
+ * Blends `count` premultiplied-alpha source pixels over destination ones, see BlendPremultiplied. Rows must not alias.
+ */
+void BlendRowPremultiplied(Color* __restrict dst, const Color* __restrict src, size_t count);
+
+/**
+ * Blends a single premultiplied color scaled by per-pixel `coverage` over `count` destination pixels. This is how
+ * antialiased lines and particles are drawn. Results are identical to
+ * BlendPremultiplied(dst, ScalePremultiplied(color, coverage)).
+ */
+void BlendSpanPremultiplied(Color* __restrict dst, Color color, const uint8_t* __restrict coverage, size_t count);
+
+/**
+ * Writes `count` premultiplied source pixels scaled by `opacity` / 255 into `dst`.
+ */
+void ScaleRowPremultiplied(Color* __restrict dst, const Color* __restrict src, uint8_t opacity, size_t count);
+
+}  // namespace ra::render
@@ -31,17 +31,26 @@ class Image {
 
   [[nodiscard]] const math::Vec2u& Extent() const;
 
+  /* Pixels are only reallocated if there are more of them than the image has ever had, contents are unspecified */
+  void Resize(const math::Vec2u& extent);
+
+  /* Bytes of pixel data */
+  [[nodiscard]] size_t SizeBytes() const;
+
  private:
   PixelData   pixels_{nullptr};
   math::Vec2u extent_{0U};
+  size_t      capacity_{0U};  // Pixels allocated
 };
 
 template <typename PixelType>
-Image<PixelType>::Image(PixelData&& pixels, const math::Vec2u& extent) : pixels_(std::move(pixels)), extent_(extent) {}
+Image<PixelType>::Image(PixelData&& pixels, const math::Vec2u& extent)
+    : pixels_(std::move(pixels)), extent_(extent), capacity_(static_cast<size_t>(extent.x) * extent.y) {}
 
 template <typename PixelType>
-Image<PixelType>::Image(const math::Vec2u& extent) : extent_(extent) {
-  pixels_ = std::make_unique<PixelType[]>(extent.x * extent.y);
+Image<PixelType>::Image(const math::Vec2u& extent)
+    : extent_(extent), capacity_(static_cast<size_t>(extent.x) * extent.y) {
+  pixels_ = std::make_unique<PixelType[]>(capacity_);
 }
 
 template <typename PixelType>
@@ -59,4 +68,20 @@ const math::Vec2u& Image<PixelType>::Extent() const {
   return extent_;
 }
 
+template <typename PixelType>
+void Image<PixelType>::Resize(const math::Vec2u& extent) {
+  const size_t pixels = static_cast<size_t>(extent.x) * extent.y;
+  if (pixels > capacity_) {
+    pixels_   = std::make_unique_for_overwrite<PixelType[]>(pixels);
+    capacity_ = pixels;
+  }
+
+  extent_ = extent;
+}
+
+template <typename PixelType>
+size_t Image<PixelType>::SizeBytes() const {
+  return (pixels_ != nullptr) ? capacity_ * sizeof(PixelType) : 0U;
+}
+
 }  // namespace ra::render
\ No newline at end of file
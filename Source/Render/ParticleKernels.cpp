@@ -0,0 +1,184 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file ParticleKernels.cpp
+ * @date 2024-08-03
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#include <Render/ParticleKernels.hpp>
+
+#include <Utils/Assert.hpp>
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(RA_COMPILER_GCC) || defined(RA_COMPILER_CLANG))
+#define RA_PARTICLES_AVX2_AVAILABLE
+#include <immintrin.h>
+#endif
+
+namespace ra::render {
+
+static void UpdateParticlesScalar(const ParticleColumns& columns, size_t count, float dt, float rotation_delta) {
+  for (size_t i = 0U; i < count; ++i) {
+    columns.translation_x[i] += columns.velocity_x[i] * dt;
+    columns.translation_y[i] += columns.velocity_y[i] * dt;
+    columns.rotation[i] += rotation_delta;
+    columns.time_remaining[i] -= dt;
+
+    /* Zero lifetime (e.g. padding past the alive range) would give 0 / 0, which clamp keeps as NaN */
+    const float lifetime = columns.lifetime[i];
+    const float t        = (lifetime > 0.0f) ? std::clamp(columns.time_remaining[i] / lifetime, 0.0f, 1.0f) : 0.0f;
+
+    math::Vec4f color;
+    for (size_t channel = 0U; channel < 4U; ++channel) {
+      color.elems[channel] = math::Lerp(columns.color_end[channel][i], columns.color_begin[channel][i], t);
+    }
+
+    /* Colors are premultiplied, see Renderer */
+    color.rgb *= color.a;
+
+    columns.color[i] = Color(color);
+    columns.size[i]  = math::Lerp(columns.size_end[i], columns.size_begin[i], t);
+  }
+}
+
+#if defined(RA_PARTICLES_AVX2_AVAILABLE)
+
+__attribute__((target("avx2,fma"))) static void UpdateParticlesAVX2(const ParticleColumns& columns, size_t count,
+                                                                    float dt, float rotation_delta) {
+  const __m256 dt8             = _mm256_set1_ps(dt);
+  const __m256 rotation_delta8 = _mm256_set1_ps(rotation_delta);
+  const __m256 zero8           = _mm256_setzero_ps();
+  const __m256 one8            = _mm256_set1_ps(1.0f);
+  const __m256 max_channel8    = _mm256_set1_ps(255.0f);
+
+  for (size_t i = 0U; i < count; i += kParticleBlockSize) {
+    /* Integration */
+    __m256 translation_x = _mm256_loadu_ps(columns.translation_x + i);
+    __m256 translation_y = _mm256_loadu_ps(columns.translation_y + i);
+    __m256 rotation      = _mm256_loadu_ps(columns.rotation + i);
+    __m256 remaining     = _mm256_loadu_ps(columns.time_remaining + i);
+
+    translation_x = _mm256_fmadd_ps(_mm256_loadu_ps(columns.velocity_x + i), dt8, translation_x);
+    translation_y = _mm256_fmadd_ps(_mm256_loadu_ps(columns.velocity_y + i), dt8, translation_y);
+    rotation      = _mm256_add_ps(rotation, rotation_delta8);
+    remaining     = _mm256_sub_ps(remaining, dt8);
+
+    _mm256_storeu_ps(columns.translation_x + i, translation_x);
+    _mm256_storeu_ps(columns.translation_y + i, translation_y);
+    _mm256_storeu_ps(columns.rotation + i, rotation);
+    _mm256_storeu_ps(columns.time_remaining + i, remaining);
+
+    /* Lifetime dependent attributes */
+    /* Same as the scalar kernel, zero for zero lifetime */
+    const __m256 lifetime = _mm256_loadu_ps(columns.lifetime + i);
+
+    __m256 t = _mm256_div_ps(remaining, lifetime);
+    t        = _mm256_min_ps(_mm256_max_ps(t, zero8), one8);
+    t        = _mm256_and_ps(t, _mm256_cmp_ps(lifetime, zero8, _CMP_GT_OQ));
+
+    const __m256 size_end   = _mm256_loadu_ps(columns.size_end + i);
+    const __m256 size_begin = _mm256_loadu_ps(columns.size_begin + i);
+    _mm256_storeu_ps(columns.size + i, _mm256_fmadd_ps(t, _mm256_sub_ps(size_begin, size_end), size_end));
+
+    /* Channels are packed in ARGB order, see Color. RGB is premultiplied by alpha, see Renderer. */
+    constexpr int kChannelShift[4U] = {16, 8, 0, 24};
+
+    const __m256 alpha_end   = _mm256_loadu_ps(columns.color_end[3U] + i);
+    const __m256 alpha_begin = _mm256_loadu_ps(columns.color_begin[3U] + i);
+    const __m256 alpha       = _mm256_fmadd_ps(t, _mm256_sub_ps(alpha_begin, alpha_end), alpha_end);
+    const __m256 rgb_scale8  = _mm256_mul_ps(alpha, max_channel8);
+
+    __m256i packed = _mm256_setzero_si256();
+    for (size_t channel = 0U; channel < 4U; ++channel) {
+      const __m256 end   = _mm256_loadu_ps(columns.color_end[channel] + i);
+      const __m256 begin = _mm256_loadu_ps(columns.color_begin[channel] + i);
+      const __m256 value = _mm256_fmadd_ps(t, _mm256_sub_ps(begin, end), end);
+      const __m256 scale = (channel == 3U) ? max_channel8 : rgb_scale8;
+
+      __m256i channel_value = _mm256_cvttps_epi32(_mm256_mul_ps(value, scale));
+      channel_value         = _mm256_and_si256(channel_value, _mm256_set1_epi32(0xFF));
+      packed = _mm256_or_si256(packed, _mm256_sllv_epi32(channel_value, _mm256_set1_epi32(kChannelShift[channel])));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(columns.color + i), packed);
+  }
+}
+
+#endif
+
+ParticleColumns ParticleColumns::Subrange(size_t first) const {
+  ParticleColumns subrange{
+    .translation_x  = translation_x + first,
+    .translation_y  = translation_y + first,
+    .rotation       = rotation + first,
+    .time_remaining = time_remaining + first,
+    .velocity_x     = velocity_x + first,
+    .velocity_y     = velocity_y + first,
+    .lifetime       = lifetime + first,
+    .size_begin     = size_begin + first,
+    .size_end       = size_end + first,
+    .color          = color + first,
+    .size           = size + first
+  };
+
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    subrange.color_begin[channel] = color_begin[channel] + first;
+    subrange.color_end[channel]   = color_end[channel] + first;
+  }
+
+  return subrange;
+}
+
+const char* ToString(ParticleKernel kernel) {
+  switch (kernel) {
+    case ParticleKernel::Scalar: { return "scalar"; }
+    case ParticleKernel::AVX2:   { return "avx2"; }
+    default:                     { return "unknown"; }
+  }
+}
+
+bool IsSupported(ParticleKernel kernel) {
+  switch (kernel) {
+    case ParticleKernel::Scalar: {
+      return true;
+    }
+
+    case ParticleKernel::AVX2: {
+#if defined(RA_PARTICLES_AVX2_AVAILABLE)
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+      return false;
+#endif
+    }
+
+    default: {
+      return false;
+    }
+  }
+}
+
+ParticleKernel BestParticleKernel() {
+  static const ParticleKernel kBestKernel =
+      IsSupported(ParticleKernel::AVX2) ? ParticleKernel::AVX2 : ParticleKernel::Scalar;
+
+  return kBestKernel;
+}
+
+void UpdateParticles(ParticleKernel kernel, const ParticleColumns& columns, size_t count, float dt,
+                     float rotation_delta) {
+  RA_ASSERT(count % kParticleBlockSize == 0U, "Particles count (%zu) must be a multiple of the block size", count);
+  RA_ASSERT(IsSupported(kernel), "Particle kernel '%s' is not supported", ToString(kernel));
+
+#if defined(RA_PARTICLES_AVX2_AVAILABLE)
+  if (kernel == ParticleKernel::AVX2) {
+    UpdateParticlesAVX2(columns, count, dt, rotation_delta);
+    return;
+  }
+#endif
+
+  UpdateParticlesScalar(columns, count, dt, rotation_delta);
+}
+
+}  // namespace ra::render
@@ -0,0 +1,67 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file ParticleKernels.hpp
+ * @date 2024-08-03
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <Render/Color.hpp>
+
+#include <cstddef>
+
+namespace ra::render {
+
+/* Particle columns are always padded to this many particles, so kernels never need a scalar tail */
+constexpr size_t kParticleBlockSize = 8U;
+
+/**
+ * Non-owning view of SoA particle columns. Columns must not alias each other.
+ */
+struct ParticleColumns {
+  float* translation_x{nullptr};
+  float* translation_y{nullptr};
+  float* rotation{nullptr};
+  float* time_remaining{nullptr};
+
+  const float* velocity_x{nullptr};
+  const float* velocity_y{nullptr};
+  const float* lifetime{nullptr};
+
+  const float* color_begin[4U]{nullptr};  // r, g, b, a
+  const float* color_end[4U]{nullptr};    // r, g, b, a
+  const float* size_begin{nullptr};
+  const float* size_end{nullptr};
+
+  Color* color{nullptr};
+  float* size{nullptr};
+
+  /** @return View of the same columns starting at particle `first`. */
+  [[nodiscard]] ParticleColumns Subrange(size_t first) const;
+};
+
+enum class ParticleKernel : uint32_t {
+  Scalar,
+  AVX2
+};
+
+[[nodiscard]] const char* ToString(ParticleKernel kernel);
+
+[[nodiscard]] bool IsSupported(ParticleKernel kernel);
+
+/**
+ * @return The fastest kernel supported by the CPU the game is running on.
+ */
+[[nodiscard]] ParticleKernel BestParticleKernel();
+
+/**
+ * Integrates `count` particles by `dt` and evaluates their lifetime-lerped color and size.
+ *
+ * @note `count` must be a multiple of kParticleBlockSize.
+ */
+void UpdateParticles(ParticleKernel kernel, const ParticleColumns& columns, size_t count, float dt,
+                     float rotation_delta);
+
+}  // namespace ra::render
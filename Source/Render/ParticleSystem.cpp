@@ -9,75 +9,346 @@
 #include <Render/ParticleSystem.hpp>
 
 #include <Asset/PolygonLoader.hpp>
-#include <Math/Mat3.hpp>
+#include <JobSystem/Executor.hpp>
+#include <Math/FastTrig.hpp>
+#include <Profile/Profiler.hpp>
 #include <Render/Renderer.hpp>
 #include <Utils/Random.hpp>
 
+#include <algorithm>
+#include <numbers>
+
 namespace ra::render {
 
 static const auto kParticlePolygon = asset::LoadPolygon("Assets/Polygons/fire_particle.txt");
 
-ParticleSystem::ParticleSystem(size_t pool_size) {
-  particles_.resize(pool_size);
+ParticleSystem::ParticleSystem(size_t pool_size)
+    : pending_bursts_(std::make_unique<PendingBursts>()), pool_size_(pool_size) {
   polygon_ = *kParticlePolygon;
 }
 
 void ParticleSystem::Update(float dt) {
-  for (auto& particle : particles_) {
-    if (!particle.active) {
-      continue;
-    }
+  Update(dt, BestParticleKernel());
+}
 
-    if (particle.time_remaining <= 0.0f) {
-      particle.active = false;
-      continue;
-    }
+void ParticleSystem::Update(float dt, ParticleKernel kernel) {
+  MergePendingBursts();
+  RemoveExpired();
+
+  UpdateParticles(kernel, particles_.Columns(), PaddedAliveCount(), dt, kParticleRotationRate * dt);
+}
+
+void ParticleSystem::Update(float dt, job::Executor& executor) {
+  /* Merging and compaction are cheap linear passes, only integration is split into jobs */
+  MergePendingBursts();
+  RemoveExpired();
+
+  const auto kernel         = BestParticleKernel();
+  const auto count          = PaddedAliveCount();
+  const auto rotation_delta = kParticleRotationRate * dt;
+
+  for (size_t first = 0U; first < count; first += kChunkSize) {
+    const size_t chunk_size = std::min(kChunkSize, count - first);
+
+    /* Columns are looked up in the job, as they don't fit into a job's inline storage */
+    executor.Submit([this, kernel, first, chunk_size, dt, rotation_delta]() {
+      RA_PROFILE_SCOPE("ParticleSystem::Update job");
+      UpdateParticles(kernel, particles_.Columns().Subrange(first), chunk_size, dt, rotation_delta);
+    });
+  }
+}
+
+void ParticleSystem::Render(render::Renderer& renderer) {
+  RenderRange(renderer, 0U, alive_count_);
+}
+
+void ParticleSystem::Render(render::Renderer& renderer, job::Executor& executor) {
+  for (size_t first = 0U; first < alive_count_; first += kChunkSize) {
+    const size_t chunk_size = std::min(kChunkSize, alive_count_ - first);
+
+    executor.Submit([this, &renderer, first, chunk_size]() {
+      RA_PROFILE_SCOPE("ParticleSystem::Render job");
+      RenderRange(renderer, first, chunk_size);
+    });
+  }
+}
+
+void ParticleSystem::EmitParticle(const ParticleSpecs& particleSpecs) {
+  EmitBurst(particleSpecs, 1U);
+}
+
+void ParticleSystem::EmitBurst(const ParticleSpecs& particleSpecs, size_t count) {
+  if (pending_bursts_ == nullptr || count == 0U) {
+    return;
+  }
+
+  const PendingBurst burst{.specs = particleSpecs, .count = count};
+  if (!pending_bursts_->buffer.Push(burst)) {
+    std::lock_guard lock(pending_bursts_->overflow_mutex);
+    pending_bursts_->overflow.push_back(burst);
+  }
+}
+
+size_t ParticleSystem::AliveCount() const {
+  return alive_count_;
+}
+
+size_t ParticleSystem::Capacity() const {
+  return particles_.time_remaining.size();
+}
+
+size_t ParticleSystem::OverflowedBursts() const {
+  return overflowed_bursts_;
+}
+
+void ParticleSystem::ReportMemory(profile::MemoryReport& report, std::string name) const {
+  const Particles::Column* columns[] = {
+    &particles_.translation_x, &particles_.translation_y, &particles_.velocity_x,     &particles_.velocity_y,
+    &particles_.rotation,      &particles_.size_begin,    &particles_.size_end,       &particles_.lifetime,
+    &particles_.size,          &particles_.time_remaining
+  };
+
+  size_t reserved = profile::VectorBytes(particles_.color);
+  for (const auto* column : columns) {
+    reserved += profile::VectorBytes(*column);
+  }
+
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    reserved += profile::VectorBytes(particles_.color_begin[channel]);
+    reserved += profile::VectorBytes(particles_.color_end[channel]);
+  }
+
+  /* Scalar columns, 4 channels of both begin and end colors, and the evaluated color */
+  constexpr size_t kParticleSize = (std::size(columns) + 8U) * sizeof(float) + sizeof(Color);
+
+  report.Add({.category       = "particles",
+              .name           = std::move(name),
+              .count          = alive_count_,
+              .capacity       = Capacity(),
+              .used_bytes     = alive_count_ * kParticleSize,
+              .reserved_bytes = reserved});
+
+  if (pending_bursts_ != nullptr) {
+    const size_t pending = pending_bursts_->buffer.View().size() + pending_bursts_->overflow.size();
+
+    report.Add({.category       = "particles",
+                .name           = "pending bursts buffer",
+                .count          = pending,
+                .capacity       = kPendingBurstsCapacity + pending_bursts_->overflow.capacity(),
+                .used_bytes     = pending * sizeof(PendingBurst),
+                .reserved_bytes = sizeof(PendingBursts) + profile::VectorBytes(pending_bursts_->overflow)});
+  }
+}
+
+void ParticleSystem::MergePendingBursts() {
+  if (pending_bursts_ == nullptr) {
+    return;
+  }
+
+  for (const auto& burst : pending_bursts_->buffer.View()) {
+    Emit(burst.specs, burst.count);
+  }
+
+  /* Emitting jobs have been waited for by now, so the overflow is read without the lock */
+  for (const auto& burst : pending_bursts_->overflow) {
+    Emit(burst.specs, burst.count);
+  }
+
+  overflowed_bursts_ = pending_bursts_->overflow.size();
+
+  pending_bursts_->buffer.Clear();
+  pending_bursts_->overflow.clear();
+}
+
+void ParticleSystem::Emit(const ParticleSpecs& particleSpecs, size_t count) {
+  count = std::min(count, pool_size_);
+  if (count == 0U) {
+    return;
+  }
+
+  Reserve(std::min(alive_count_ + count, pool_size_));
+
+  /* All random numbers of the burst are generated at once, one block of `count` numbers per randomized attribute */
+  thread_local std::vector<float> random;
+  random.resize(kRandomAttributesCount * count);
+  utils::Random::Instance().FillNormalized(random);
+
+  /* Append as many particles as possible to the alive range, then overwrite the oldest ones */
+  const size_t appended = std::min(count, pool_size_ - alive_count_);
+  FillParticles(particleSpecs, alive_count_, appended, random.data(), count);
+  alive_count_ += appended;
+
+  for (size_t filled = appended; filled < count;) {
+    const size_t segment = std::min(count - filled, pool_size_ - next_particle_);
+    FillParticles(particleSpecs, next_particle_, segment, random.data() + filled, count);
+
+    next_particle_ = (next_particle_ + segment) % pool_size_;
+    filled += segment;
+  }
+}
+
+void ParticleSystem::Reserve(size_t count) {
+  const size_t capacity = Capacity();
+  if (count <= capacity) {
+    return;
+  }
+
+  /* Grow geometrically to amortize reallocation, but never past the (padded) pool size */
+  const size_t max_capacity = (pool_size_ + kParticleBlockSize - 1U) / kParticleBlockSize * kParticleBlockSize;
+  const size_t new_capacity = std::min(std::max(count, 2U * capacity), max_capacity);
+
+  particles_.Resize((new_capacity + kParticleBlockSize - 1U) / kParticleBlockSize * kParticleBlockSize);
+}
+
+void ParticleSystem::FillParticles(const ParticleSpecs& specs, size_t first, size_t count, const float* random,
+                                   size_t random_stride) {
+  const float* random_rotation   = random;
+  const float* random_velocity_x = random + random_stride;
+  const float* random_velocity_y = random + 2U * random_stride;
+  const float* random_origin_x   = random + 3U * random_stride;
+  const float* random_origin_y   = random + 4U * random_stride;
+  const float* random_size       = random + 5U * random_stride;
+
+  const auto color = Color(math::Vec4f(specs.color_begin.rgb * specs.color_begin.a, specs.color_begin.a));
+
+  /* Column by column, so that each loop is a simple streaming store */
+  for (size_t i = 0U; i < count; ++i) {
+    particles_.translation_x[first + i] = specs.origin.x + (random_origin_x[i] - 0.5f) * specs.origin_variation.x;
+    particles_.translation_y[first + i] = specs.origin.y + (random_origin_y[i] - 0.5f) * specs.origin_variation.y;
+  }
 
-    particle.translation += particle.velocity * dt;
-    particle.rotation += kParticleRotationRate * dt;
-    particle.time_remaining -= dt;
+  for (size_t i = 0U; i < count; ++i) {
+    particles_.velocity_x[first + i] = specs.velocity.x + (random_velocity_x[i] - 0.5f) * specs.velocity_variation.x;
+    particles_.velocity_y[first + i] = specs.velocity.y + (random_velocity_y[i] - 0.5f) * specs.velocity_variation.y;
   }
+
+  for (size_t i = 0U; i < count; ++i) {
+    particles_.rotation[first + i] = random_rotation[i] * std::numbers::pi_v<float>;
+  }
+
+  for (size_t i = 0U; i < count; ++i) {
+    particles_.size_begin[first + i] = specs.size_begin + specs.size_variation * (random_size[i] - 0.5f);
+  }
+
+  std::fill_n(particles_.size_end.begin() + first, count, specs.size_end);
+  std::fill_n(particles_.lifetime.begin() + first, count, specs.lifetime);
+  std::fill_n(particles_.time_remaining.begin() + first, count, specs.lifetime);
+
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    std::fill_n(particles_.color_begin[channel].begin() + first, count, specs.color_begin.elems[channel]);
+    std::fill_n(particles_.color_end[channel].begin() + first, count, specs.color_end.elems[channel]);
+  }
+
+  /* Particles may be rendered before the next update */
+  std::fill_n(particles_.color.begin() + first, count, color);
+  std::copy_n(particles_.size_begin.begin() + first, count, particles_.size.begin() + first);
 }
 
-void ParticleSystem::Render(render::Renderer& renderer){
-  for (auto& particle : particles_) {
-    if (!particle.active) {
+void ParticleSystem::RemoveExpired() {
+  size_t i = 0U;
+  while (i < alive_count_) {
+    if (particles_.time_remaining[i] > 0.0f) {
+      ++i;
       continue;
     }
 
-    float       lifetime_percentage = particle.time_remaining / particle.lifetime;
-    math::Vec4f color               = math::Lerp(particle.color_end, particle.color_begin, lifetime_percentage);
-    float       size                = math::Lerp(particle.size_end, particle.size_begin, lifetime_percentage);
+    --alive_count_;
+    if (i != alive_count_) {
+      particles_.Copy(alive_count_, i);
+    }
+  }
+
+  next_particle_ = 0U;
+}
+
+void ParticleSystem::RenderRange(render::Renderer& renderer, size_t first, size_t count) const {
+  /* Particles are rendered from multiple jobs at once, so each thread has its own scratch buffer */
+  thread_local std::vector<ParticleInstance> instances;
+  thread_local std::vector<float>            rotation_sin;
+  thread_local std::vector<float>            rotation_cos;
+  instances.resize(count);
+  rotation_sin.resize(count);
+  rotation_cos.resize(count);
+
+  math::FastSinCos(particles_.rotation.data() + first, rotation_sin.data(), rotation_cos.data(), count);
 
-    polygon_.color        = Color(color);
-    math::Mat3f transform = math::TranslationMatrix(particle.translation) * math::RotationMatrix(particle.rotation) *
-                            math::ScaleMatrix(math::Vec2f(size, size));
+  for (size_t i = 0U; i < count; ++i) {
+    const size_t particle = first + i;
 
-    renderer.CmdDrawPolygon(polygon_, transform);
+    instances[i] = {
+      .ws_position = math::Vec2f(particles_.translation_x[particle], particles_.translation_y[particle]),
+      .rotation    = math::Vec2f(rotation_cos[i], rotation_sin[i]),
+      .size        = particles_.size[particle],
+      .color       = particles_.color[particle]
+    };
   }
+
+  renderer.CmdDrawParticles(polygon_, instances);
 }
 
-void ParticleSystem::EmitParticle(const ParticleSpecs& particleSpecs) {
-  Particle& particle = particles_[next_particle_];
-  particle.active    = true;
+size_t ParticleSystem::PaddedAliveCount() const {
+  return (alive_count_ + kParticleBlockSize - 1U) / kParticleBlockSize * kParticleBlockSize;
+}
+
+void ParticleSystem::Particles::Resize(size_t size) {
+  translation_x.resize(size);
+  translation_y.resize(size);
+  velocity_x.resize(size);
+  velocity_y.resize(size);
+  rotation.resize(size);
+  size_begin.resize(size);
+  size_end.resize(size);
+  lifetime.resize(size);
+  time_remaining.resize(size);
+  color.resize(size);
+  this->size.resize(size);
 
-  particle.translation = particleSpecs.origin;
-  particle.rotation    = utils::Random::Instance().Normalized() * M_PI;
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    color_begin[channel].resize(size);
+    color_end[channel].resize(size);
+  }
+}
+
+void ParticleSystem::Particles::Copy(size_t from, size_t to) {
+  translation_x[to]  = translation_x[from];
+  translation_y[to]  = translation_y[from];
+  velocity_x[to]     = velocity_x[from];
+  velocity_y[to]     = velocity_y[from];
+  rotation[to]       = rotation[from];
+  size_begin[to]     = size_begin[from];
+  size_end[to]       = size_end[from];
+  lifetime[to]       = lifetime[from];
+  time_remaining[to] = time_remaining[from];
+  color[to]          = color[from];
+  size[to]           = size[from];
 
-  particle.velocity = particleSpecs.velocity;
-  particle.velocity.x += (utils::Random::Instance().Normalized() - 0.5f) * particleSpecs.velocity_variation.x;
-  particle.velocity.y += (utils::Random::Instance().Normalized() - 0.5f) * particleSpecs.velocity_variation.y;
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    color_begin[channel][to] = color_begin[channel][from];
+    color_end[channel][to]   = color_end[channel][from];
+  }
+}
 
-  particle.color_begin = particleSpecs.color_begin;
-  particle.color_end   = particleSpecs.color_end;
+ParticleColumns ParticleSystem::Particles::Columns() {
+  ParticleColumns columns{
+    .translation_x  = translation_x.data(),
+    .translation_y  = translation_y.data(),
+    .rotation       = rotation.data(),
+    .time_remaining = time_remaining.data(),
+    .velocity_x     = velocity_x.data(),
+    .velocity_y     = velocity_y.data(),
+    .lifetime       = lifetime.data(),
+    .size_begin     = size_begin.data(),
+    .size_end       = size_end.data(),
+    .color          = color.data(),
+    .size           = size.data()
+  };
 
-  particle.lifetime       = particleSpecs.lifetime;
-  particle.time_remaining = particleSpecs.lifetime;
-  particle.size_begin     = particleSpecs.size_begin;
-  particle.size_end       = particleSpecs.size_end;
-  particle.size_begin += particleSpecs.size_variation * (utils::Random::Instance().Normalized() - 0.5f);
+  for (size_t channel = 0U; channel < 4U; ++channel) {
+    columns.color_begin[channel] = color_begin[channel].data();
+    columns.color_end[channel]   = color_end[channel].data();
+  }
 
-  next_particle_ = (next_particle_ + 1) % particles_.size();
+  return columns;
 }
 
 }  // namespace ra::render
\ No newline at end of file
@@ -8,16 +8,36 @@
 
 #pragma once
 
+#include <Profile/MemoryReport.hpp>
+#include <Render/ParticleKernels.hpp>
 #include <Render/Polygon.hpp>
+#include <Utils/AppendBuffer.hpp>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace ra::render {
 
 class Renderer;
 
+}  // namespace ra::render
+
+namespace ra::job {
+
+class Executor;
+
+}  // namespace ra::job
+
+namespace ra::render {
+
 class ParticleSystem {
  public:
   struct ParticleSpecs {
     math::Vec2f origin;
+    math::Vec2f origin_variation{0.0f};
     math::Vec2f velocity;
     math::Vec2f velocity_variation;
 
@@ -31,36 +51,122 @@ class ParticleSystem {
     float lifetime{1.0f};
   };
 
+  /* Update and render are split into jobs of this many particles */
+  static constexpr size_t kChunkSize = 1024U;
+
   ParticleSystem() = default;
+
+  /**
+   * @param pool_size Maximum number of alive particles, the oldest ones are overwritten past it. Storage is not
+   *                  preallocated, it grows with the number of alive particles.
+   */
   explicit ParticleSystem(size_t pool_size);
 
   void Update(float dt);
+  void Update(float dt, ParticleKernel kernel);
+
+  /**
+   * Submits one update job per chunk of kChunkSize particles. The system must not be updated or rendered until the
+   * executor is waited for, emitting particles is allowed.
+   */
+  void Update(float dt, job::Executor& executor);
+
   void Render(render::Renderer& renderer);
 
+  /**
+   * Submits one render job per chunk of kChunkSize particles.
+   */
+  void Render(render::Renderer& renderer, job::Executor& executor);
+
   void EmitParticle(const ParticleSpecs& particleSpecs);
 
- private:
-  struct Particle {
-    math::Vec2f translation;
-    math::Vec2f velocity;
-    float       rotation{0.0f};
-    math::Vec4f color_begin;
-    math::Vec4f color_end;
+  /**
+   * Emits `count` particles with the same specs. Bursts are appended to a lock-free buffer and merged into the pool
+   * on the next update, so emitting is safe while update jobs are running. Once the buffer is full, bursts are appended
+   * to an overflow vector under a lock instead, none are dropped.
+   *
+   * Random numbers for the whole burst are generated in bulk, so this is much cheaper than calling EmitParticle `count`
+   * times.
+   */
+  void EmitBurst(const ParticleSpecs& particleSpecs, size_t count);
 
-    float size_begin{0.0f};
-    float size_end{1.0f};
+  [[nodiscard]] size_t AliveCount() const;
 
-    float lifetime{1.0f};
-    float time_remaining{0.0f};
+  /** @return Number of particles storage is currently allocated for. */
+  [[nodiscard]] size_t Capacity() const;
+
+  /** @return Number of bursts merged by the last update that didn't fit into the lock-free buffer. */
+  [[nodiscard]] size_t OverflowedBursts() const;
 
-    bool active{false};
+  /* Adds particle columns (alive particles vs capacity) and the pending bursts buffer */
+  void ReportMemory(profile::MemoryReport& report, std::string name) const;
+
+ private:
+  /**
+   * Particle state is stored as SoA columns. Alive particles always occupy the dense range [0, alive_count_), dead
+   * ones are swap-removed, so that update and render only ever touch alive particles.
+   *
+   * Color and size are evaluated during update, render only reads them.
+   */
+  struct Particles {
+    using Column = std::vector<float>;
+
+    Column                translation_x;
+    Column                translation_y;
+    Column                velocity_x;
+    Column                velocity_y;
+    Column                rotation;
+    std::array<Column, 4> color_begin;
+    std::array<Column, 4> color_end;
+    Column                size_begin;
+    Column                size_end;
+    Column                lifetime;
+    Column                time_remaining;
+
+    std::vector<Color> color;
+    Column             size;
+
+    void Resize(size_t size);
+    void Copy(size_t from, size_t to);
+
+    ParticleColumns Columns();
+  };
+
+  struct PendingBurst {
+    ParticleSpecs specs;
+    size_t        count{0U};
   };
 
-  static constexpr float kParticleRotationRate = 0.02f;
+  static constexpr float  kParticleRotationRate  = 0.02f;
+  static constexpr size_t kRandomAttributesCount = 6U;     // Rotation, velocity (x, y), origin (x, y) and size
+  static constexpr size_t kPendingBurstsCapacity = 4096U;  // Bursts past this take the locked overflow path
+
+  /* Heap allocated, as the system is movable and the mutex is not */
+  struct PendingBursts {
+    utils::AppendBuffer<PendingBurst, kPendingBurstsCapacity> buffer;
+    std::mutex                                               overflow_mutex;
+    std::vector<PendingBurst>                                overflow;
+  };
 
-  Polygon               polygon_;
-  std::vector<Particle> particles_;
-  uint32_t              next_particle_{0U};
+  void MergePendingBursts();
+  void Emit(const ParticleSpecs& specs, size_t count);
+  void Reserve(size_t count);
+  void FillParticles(const ParticleSpecs& specs, size_t first, size_t count, const float* random,
+                     size_t random_stride);
+  void RemoveExpired();
+  void RenderRange(render::Renderer& renderer, size_t first, size_t count) const;
+
+  /* Columns are padded to kParticleBlockSize, so kernels run over whole blocks without a scalar tail. Updating a few
+   * dead particles past the alive range is harmless. */
+  [[nodiscard]] size_t PaddedAliveCount() const;
+
+  Polygon                        polygon_;
+  Particles                      particles_;
+  std::unique_ptr<PendingBursts> pending_bursts_;
+  size_t    pool_size_{0U};
+  size_t    alive_count_{0U};
+  size_t    next_particle_{0U};  // Slot to overwrite when the pool is full
+  size_t    overflowed_bursts_{0U};
 };
 
 }  // namespace ra::render
\ No newline at end of file
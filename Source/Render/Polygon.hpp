@@ -11,6 +11,7 @@
 #include <Math/Vec2.hpp>
 #include <Render/Color.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace ra::render {
@@ -21,9 +22,49 @@ struct Polygon {
     bool        split;
   };
 
+  struct Bounds {
+    math::Vec2f aabb_min{0.0f};
+    math::Vec2f aabb_max{0.0f};
+
+    math::Vec2f center{0.0f};
+    float       radius{0.0f};
+  };
+
   std::vector<Vertex> vertices;
   Color               color;
   float               thickness;
+  Bounds              ms_bounds;
 };
 
+/**
+ * Calculates model space AABB and bounding circle (centered at the AABB's center) of the polygon's vertices.
+ */
+inline Polygon::Bounds CalculateBounds(const Polygon& polygon) {
+  Polygon::Bounds bounds;
+  if (polygon.vertices.empty()) {
+    return bounds;
+  }
+
+  bounds.aabb_min = polygon.vertices.front().ms_position;
+  bounds.aabb_max = polygon.vertices.front().ms_position;
+
+  for (const auto& vertex : polygon.vertices) {
+    bounds.aabb_min = math::Vec2f(std::min(bounds.aabb_min.x, vertex.ms_position.x),
+                                  std::min(bounds.aabb_min.y, vertex.ms_position.y));
+    bounds.aabb_max = math::Vec2f(std::max(bounds.aabb_max.x, vertex.ms_position.x),
+                                  std::max(bounds.aabb_max.y, vertex.ms_position.y));
+  }
+
+  bounds.center = 0.5f * (bounds.aabb_min + bounds.aabb_max);
+
+  float radius_squared = 0.0f;
+  for (const auto& vertex : polygon.vertices) {
+    radius_squared = std::max(radius_squared, math::LengthSquared(vertex.ms_position - bounds.center));
+  }
+
+  bounds.radius = std::sqrt(radius_squared);
+
+  return bounds;
+}
+
 }  // namespace ra::render
@@ -8,8 +8,14 @@
 
 #include <Render/Renderer.hpp>
 
+#include <Profile/Profiler.hpp>
+#include <Render/BlendKernels.hpp>
 #include <Utils/Assert.hpp>
 
+#include <array>
+#include <limits>
+#include <vector>
+
 namespace ra::render {
 
 /**
@@ -29,19 +35,84 @@ static constexpr inline float CapsuleSDF(math::Vec2f pixel, math::Vec2f from, ma
   return math::Length(delta) - thickness;
 }
 
+static inline bool IsDigit(char ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+/* Coverage of a pixel at signed distance `sdf` from a primitive's edge, in [0, 255] */
+static inline uint8_t Coverage(float sdf) {
+  return static_cast<uint8_t>(std::clamp(0.5f - sdf, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
 void Renderer::BeginFrame(ImageView<Color> render_target) {
   rt_            = render_target;
+  stats_         = Stats{};
+
+  UpdateFramebufferTransform();
+
+  /* Whatever was drawn last frame has to be restored, everything on the first frame and on resize */
+  const auto tiles_extent = (rt_.Extent() + math::Vec2u(kDamageTileSize - 1U)) / kDamageTileSize;
+
+  if (tiles_extent != tiles_extent_) {
+    tiles_extent_ = tiles_extent;
+    tiles_        = std::vector<std::atomic<uint8_t>>(tiles_extent.x * tiles_extent.y);
+
+    /* There are never more regions than tiles, so collecting them doesn't allocate from then on */
+    restore_regions_.reserve(tiles_.size());
+    damaged_regions_.reserve(tiles_.size());
+
+    for (auto& tile : tiles_) {
+      tile.store(kTileRestored, std::memory_order_relaxed);
+    }
+  } else {
+    for (auto& tile : tiles_) {
+      const bool drawn = tile.load(std::memory_order_relaxed) & kTileDrawn;
+      tile.store(drawn ? kTileRestored : 0U, std::memory_order_relaxed);
+    }
+  }
+
+  CollectRegions(kTileRestored, restore_regions_);
+
+  ++frame_index_;
+  for (auto it = text_runs_.begin(); it != text_runs_.end();) {
+    /* Single characters, i.e. digits of numbers, are kept, so that numbers never have to composite them again */
+    const auto run = it++;
+    if (run->first.text.size() > 1U && frame_index_ - run->second.last_used_frame > kTextRunMaxUnusedFrames) {
+      free_text_runs_.push_back(text_runs_.extract(run));
+    }
+  }
 }
 
 void Renderer::EndFrame() {
+  CollectRegions(kTileDrawn | kTileDamaged | kTileRestored, damaged_regions_);
+
+  for (const auto& region : damaged_regions_) {
+    stats_.damaged_pixels += region.extent.x * region.extent.y;
+  }
 }
 
 void Renderer::CmdSetViewInfo(math::Mat3f proj_view, math::Mat3f inv_proj_view) {
   proj_view_     = std::move(proj_view);
   inv_proj_view_ = std::move(inv_proj_view);
+
+  UpdateFramebufferTransform();
+
+  auto ws_corner0 = math::Vec2f(inv_proj_view_ * math::Vec3f(-1.0f, -1.0f, 1.0f));
+  auto ws_corner1 = math::Vec2f(inv_proj_view_ * math::Vec3f(1.0f, 1.0f, 1.0f));
+
+  ws_view_min_ = math::Vec2f(std::min(ws_corner0.x, ws_corner1.x), std::min(ws_corner0.y, ws_corner1.y));
+  ws_view_max_ = math::Vec2f(std::max(ws_corner0.x, ws_corner1.x), std::max(ws_corner0.y, ws_corner1.y));
+
+  if (rt_.Extent().x > 0U && rt_.Extent().y > 0U) {
+    auto ws_guard_band = kCullGuardBandPixels * (ws_view_max_ - ws_view_min_) / math::Vec2f(rt_.Extent());
+    ws_view_min_ -= ws_guard_band;
+    ws_view_max_ += ws_guard_band;
+  }
 }
 
 void Renderer::CmdClear(Color clear_color) {
+  MarkTiles(math::Vec2i(0), math::Vec2i(rt_.Extent()) - math::Vec2i(1), kTileDrawn);
+
   if (rt_.Offset() == math::Vec2u(0U)) {
     auto data = rt_.Data();
     std::fill(data.begin(), data.end(), clear_color);
@@ -56,66 +127,482 @@ void Renderer::CmdClear(Color clear_color) {
 
 void Renderer::CmdDrawLine(const math::Vec2f& ms_from, const math::Vec2f& ms_to, const math::Mat3f& transform,
                            Color color, float thickness) {
-  auto from = ConvertNDCToFramebuffer(math::Vec2f(proj_view_ * transform * math::Vec3f(ms_from, 1.0f)));
-  auto to   = ConvertNDCToFramebuffer(math::Vec2f(proj_view_ * transform * math::Vec3f(ms_to, 1.0f)));
+  RA_PROFILE_SCOPE("Renderer::CmdDrawLine");
 
-  auto x0 = static_cast<int32_t>(std::floor(std::min(from.x, to.x) - thickness));
-  auto x1 = static_cast<int32_t>(std::ceil(std::max(from.x, to.x) + thickness));
+  const auto fb_transform = fb_proj_view_ * transform;
 
-  auto y0 = static_cast<int32_t>(std::floor(std::min(from.y, to.y) - thickness));
-  auto y1 = static_cast<int32_t>(std::ceil(std::max(from.y, to.y) + thickness));
+  auto from = math::Vec2f(fb_transform * math::Vec3f(ms_from, 1.0f));
+  auto to   = math::Vec2f(fb_transform * math::Vec3f(ms_to, 1.0f));
+
+  RasterizeLine(from, to, PremultiplyAlpha(color), thickness);
+}
 
-  math::Vec4f colorf(color);
+void Renderer::CmdDrawPolygon(const Polygon& polygon, const math::Mat3f& transform) {
+  RA_PROFILE_SCOPE("Renderer::CmdDrawPolygon");
 
-  for (int32_t y = y0; y <= y1; ++y) {
-    for (int32_t x = x0; x <= x1; ++x) {
-      float alpha = std::max(std::min(0.5f - CapsuleSDF(math::Vec2f(x, y), from, to, thickness), 1.0f), 0.0f);
-      SetPixelBlended(math::Vec2i(x, y), math::Vec4f(colorf.rgb, colorf.a * alpha));
+  /* Polygons are recorded from multiple jobs at once, so each thread has its own scratch buffers */
+  thread_local std::vector<float> fb_x;
+  thread_local std::vector<float> fb_y;
+
+  const size_t vertices_count = polygon.vertices.size();
+  if (vertices_count == 0U) {
+    return;
+  }
+
+  const Color color = PremultiplyAlpha(polygon.color);
+
+  fb_x.resize(vertices_count);
+  fb_y.resize(vertices_count);
+
+  /* Transform each vertex exactly once, the loop is simple enough to be vectorized */
+  const auto fb_transform = fb_proj_view_ * transform;
+  const auto m            = fb_transform.elements;
+
+  for (size_t vertex = 0U; vertex < vertices_count; ++vertex) {
+    const auto& ms_position = polygon.vertices[vertex].ms_position;
+
+    fb_x[vertex] = m[0] * ms_position.x + m[1] * ms_position.y + m[2];
+    fb_y[vertex] = m[3] * ms_position.x + m[4] * ms_position.y + m[5];
+  }
+
+  for (size_t vertex = 0U; vertex < vertices_count; ++vertex) {
+    const size_t next_vertex = (vertex + 1U == vertices_count) ? 0U : vertex + 1U;
+
+    if (polygon.vertices[vertex].split || polygon.vertices[next_vertex].split) {
+      continue;
     }
+
+    RasterizeLine(math::Vec2f(fb_x[vertex], fb_y[vertex]), math::Vec2f(fb_x[next_vertex], fb_y[next_vertex]),
+                  color, polygon.thickness);
   }
 }
 
-void Renderer::CmdDrawPolygon(const Polygon& polygon, const math::Mat3f& transform) {
-  size_t vertices_count = polygon.vertices.size();
+void Renderer::CmdDrawParticles(const Polygon& shape, std::span<const ParticleInstance> particles) {
+  constexpr size_t kMaxShapeVertices = 16U;
+
+  RA_ASSERT(shape.vertices.size() <= kMaxShapeVertices, "Particle shape has too many vertices (%zu, max is %zu)",
+            shape.vertices.size(), kMaxShapeVertices);
 
-  for (uint32_t vertex = 0U; vertex < vertices_count; ++vertex) {
-    if (polygon.vertices[vertex].split || polygon.vertices[(vertex + 1U) % vertices_count].split) {
+  const size_t vertices_count = std::min(shape.vertices.size(), kMaxShapeVertices);
+  const float  thickness      = shape.thickness;
+
+  /* Edges are the same for all instances */
+  std::array<std::pair<uint32_t, uint32_t>, kMaxShapeVertices> edges;
+  size_t                                                       edges_count = 0U;
+
+  for (size_t vertex = 0U; vertex < vertices_count; ++vertex) {
+    const size_t next_vertex = (vertex + 1U == vertices_count) ? 0U : vertex + 1U;
+
+    if (!shape.vertices[vertex].split && !shape.vertices[next_vertex].split) {
+      edges[edges_count++] = {static_cast<uint32_t>(vertex), static_cast<uint32_t>(next_vertex)};
+    }
+  }
+
+  if (edges_count == 0U) {
+    return;
+  }
+
+  const auto  m         = fb_proj_view_.elements;
+  const float fb_width  = static_cast<float>(rt_.Extent().x);
+  const float fb_height = static_cast<float>(rt_.Extent().y);
+
+  std::array<math::Vec2f, kMaxShapeVertices> fb_vertices;
+
+  for (const auto& particle : particles) {
+    /* Linear part of fb_proj_view_ * Translation * Rotation * Scale, without building any matrices */
+    const float cos = particle.rotation.x * particle.size;
+    const float sin = particle.rotation.y * particle.size;
+
+    const float a00 = m[0] * cos + m[1] * sin;
+    const float a01 = m[1] * cos - m[0] * sin;
+    const float a10 = m[3] * cos + m[4] * sin;
+    const float a11 = m[4] * cos - m[3] * sin;
+
+    const float tx = m[0] * particle.ws_position.x + m[1] * particle.ws_position.y + m[2];
+    const float ty = m[3] * particle.ws_position.x + m[4] * particle.ws_position.y + m[5];
+
+    math::Vec2f fb_min(tx, ty);
+    math::Vec2f fb_max(tx, ty);
+
+    for (size_t vertex = 0U; vertex < vertices_count; ++vertex) {
+      const auto& ms_position = shape.vertices[vertex].ms_position;
+
+      fb_vertices[vertex] = math::Vec2f(a00 * ms_position.x + a01 * ms_position.y + tx,
+                                        a10 * ms_position.x + a11 * ms_position.y + ty);
+
+      fb_min = math::Vec2f(std::min(fb_min.x, fb_vertices[vertex].x), std::min(fb_min.y, fb_vertices[vertex].y));
+      fb_max = math::Vec2f(std::max(fb_max.x, fb_vertices[vertex].x), std::max(fb_max.y, fb_vertices[vertex].y));
+    }
+
+    /* Spans are blended without per-pixel bounds checks, so off-screen (or NaN) bounds must never reach the casts */
+    const bool on_screen = fb_max.x + thickness >= 0.0f && fb_min.x - thickness <= fb_width - 1.0f &&
+                           fb_max.y + thickness >= 0.0f && fb_min.y - thickness <= fb_height - 1.0f;
+    if (!on_screen) {
       continue;
     }
 
-    CmdDrawLine(polygon.vertices[vertex].ms_position, polygon.vertices[(vertex + 1U) % vertices_count].ms_position,
-                transform, polygon.color, polygon.thickness);
+    auto x0 = static_cast<int32_t>(std::floor(std::max(fb_min.x - thickness, 0.0f)));
+    auto x1 = static_cast<int32_t>(std::ceil(std::min(fb_max.x + thickness, fb_width - 1.0f)));
+    auto y0 = static_cast<int32_t>(std::floor(std::max(fb_min.y - thickness, 0.0f)));
+    auto y1 = static_cast<int32_t>(std::ceil(std::min(fb_max.y + thickness, fb_height - 1.0f)));
+
+    MarkTiles(math::Vec2i(x0, y0), math::Vec2i(x1, y1), kTileDrawn);
+
+    std::array<uint8_t, kBlendSpanSize> coverage;
+
+    for (int32_t y = y0; y <= y1; ++y) {
+      for (int32_t span_x = x0; span_x <= x1; span_x += kBlendSpanSize) {
+        const auto span_size = std::min<size_t>(kBlendSpanSize, x1 - span_x + 1);
+
+        for (size_t i = 0U; i < span_size; ++i) {
+          const auto pixel = math::Vec2f(span_x + i, y);
+
+          float sdf = std::numeric_limits<float>::max();
+          for (size_t edge = 0U; edge < edges_count; ++edge) {
+            sdf = std::min(sdf, CapsuleSDF(pixel, fb_vertices[edges[edge].first], fb_vertices[edges[edge].second],
+                                           thickness));
+          }
+
+          coverage[i] = Coverage(sdf);
+        }
+
+        BlendSpanPremultiplied(&rt_(span_x, y), particle.color, coverage.data(), span_size);
+      }
+    }
   }
 }
 
 void Renderer::CmdDrawImage(ImageView<Color const> view, const math::Vec2f& ndc_pos, float transparency) {
-  CmdDrawImage(view, math::Vec2i(ConvertNDCToFramebuffer(ndc_pos)));
+  const auto opacity = static_cast<uint8_t>(std::clamp(transparency, 0.0f, 1.0f) * 255.0f + 0.5f);
+  CmdDrawImage(view, math::Vec2i(ConvertNDCToFramebuffer(ndc_pos)), opacity);
 }
 
 void Renderer::CmdDrawText(std::string_view text, const math::Vec2f& ndc_pos, const asset::FontAtlas& font,
                            float transparency) {
-  auto cur_pos = math::Vec2i(ConvertNDCToFramebuffer(ndc_pos)) + math::Vec2i(font.padding_urdl.x, font.padding_urdl.w);
+  const auto pen   = math::Vec2i(ConvertNDCToFramebuffer(ndc_pos)) + math::Vec2i(font.padding_urdl.x, font.padding_urdl.w);
+  const auto alpha = static_cast<uint8_t>(std::clamp(transparency, 0.0f, 1.0f) * 255.0f + 0.5f);
 
-  for (char ch : text) {
-    const auto& ch_info = font.characters.at(ch);
-    const auto& view    = font.image_views.at(ch);
+  /* Every digit is a run of its own, so that changing numbers (e.g. the score) are drawn from a few cached runs */
+  auto pen_x = pen.x;
+  while (!text.empty()) {
+    const size_t size    = IsDigit(text[0]) ? 1U : std::min(text.find_first_of("0123456789"), text.size());
+    const auto   segment = text.substr(0U, size);
+
+    const size_t runs_count = text_runs_.size();
+    const auto&  run        = GetTextRun(segment, font, alpha);
+    CmdDrawImage(run.image.CreateView(), math::Vec2i(pen_x, pen.y) + run.offset);
+
+    /* A number needs the rest of the digits sooner or later, they are composited along with the first one */
+    if (IsDigit(segment[0]) && text_runs_.size() > runs_count) {
+      for (char digit = '0'; digit <= '9'; ++digit) {
+        GetTextRun(std::string_view(&digit, 1U), font, alpha);
+      }
+    }
+
+    for (char ch : segment) {
+      pen_x += font.spacing.x + font.characters[static_cast<uint8_t>(ch)].advance;
+    }
+
+    text.remove_prefix(size);
+  }
+}
 
-    CmdDrawImage(view, cur_pos + ch_info.offset, transparency);
-    cur_pos.x += font.spacing.x + ch_info.advance;
+void Renderer::CullCircles(std::span<const float> ws_x, std::span<const float> ws_y, std::span<const float> ws_radius,
+                           std::span<uint8_t> visible) {
+  RA_ASSERT(ws_x.size() == ws_y.size() && ws_x.size() == ws_radius.size() && ws_x.size() == visible.size(),
+            "Culling spans must be of the same size (%zu)", ws_x.size());
+
+  const auto  count = ws_x.size();
+  const float min_x = ws_view_min_.x;
+  const float min_y = ws_view_min_.y;
+  const float max_x = ws_view_max_.x;
+  const float max_y = ws_view_max_.y;
+  uint32_t    drawn = 0U;
+
+  /* Branch-free, so that the compiler is able to vectorize the loop */
+  for (size_t i = 0U; i < count; ++i) {
+    const float r = ws_radius[i];
+
+    visible[i] = static_cast<uint8_t>((ws_x[i] + r >= min_x) & (ws_x[i] - r <= max_x) & (ws_y[i] + r >= min_y) &
+                                      (ws_y[i] - r <= max_y));
+    drawn += visible[i];
   }
+
+  stats_.polygons_drawn += drawn;
+  stats_.polygons_culled += static_cast<uint32_t>(count) - drawn;
 }
 
 math::Vec2f Renderer::ScreenSpaceToWorld(const math::Vec2u& ss_pos) const {
   return math::Vec2f(inv_proj_view_ * math::Vec3f(ConvertFramebufferToNDC(math::Vec2f(ss_pos)), 1.0f));
 }
 
-void Renderer::CmdDrawImage(ImageView<const Color> view, const math::Vec2i& pos, float transparency) {
-  for (uint32_t y = 0U; y < view.Extent().y; ++y) {
-    for (uint32_t x = 0U; x < view.Extent().x; ++x) {
-      auto color = math::Vec4f(view(x, y));
-      color.a *= transparency;
+void Renderer::MarkDamaged(const Region& region) {
+  MarkTiles(math::Vec2i(region.offset), math::Vec2i(region.offset + region.extent) - math::Vec2i(1), kTileDamaged);
+}
+
+std::span<const Region> Renderer::RestoreRegions() const {
+  return restore_regions_;
+}
+
+std::span<const Region> Renderer::DamagedRegions() const {
+  return damaged_regions_;
+}
+
+const Renderer::Stats& Renderer::FrameStats() const {
+  return stats_;
+}
+
+void Renderer::ReportMemory(profile::MemoryReport& report) const {
+  report.Add({.category       = "renderer",
+              .name           = "damage tiles",
+              .count          = tiles_.size(),
+              .capacity       = tiles_.capacity(),
+              .used_bytes     = tiles_.size() * sizeof(tiles_[0U]),
+              .reserved_bytes = profile::VectorBytes(tiles_)});
+
+  report.Add({.category       = "renderer",
+              .name           = "restore and damaged regions",
+              .count          = restore_regions_.size() + damaged_regions_.size(),
+              .capacity       = restore_regions_.capacity() + damaged_regions_.capacity(),
+              .used_bytes     = (restore_regions_.size() + damaged_regions_.size()) * sizeof(Region),
+              .reserved_bytes = profile::VectorBytes(restore_regions_) + profile::VectorBytes(damaged_regions_)});
+
+  /* Keys of short strings are stored inline, longer ones allocate their capacity */
+  size_t images = 0U;
+  size_t keys   = 0U;
+  for (const auto& [key, run] : text_runs_) {
+    images += run.image.SizeBytes();
+    keys   += (key.text.capacity() > std::string().capacity()) ? key.text.capacity() + 1U : 0U;
+  }
+
+  for (const auto& node : free_text_runs_) {
+    images += node.mapped().image.SizeBytes();
+  }
+
+  report.Add({.category       = "renderer",
+              .name           = "text runs",
+              .count          = text_runs_.size(),
+              .capacity       = text_runs_.size() + free_text_runs_.size(),
+              .used_bytes     = images,
+              .reserved_bytes = images + keys + profile::HashMapBytes(text_runs_)});
+}
+
+size_t Renderer::TextRunKeyHash::operator()(const TextRunKey& key) const {
+  size_t hash = std::hash<std::string>{}(key.text);
+  hash ^= std::hash<const void*>{}(key.font) + 0x9E3779B97F4A7C15ULL + (hash << 6U) + (hash >> 2U);
+  hash ^= std::hash<uint8_t>{}(key.alpha) + 0x9E3779B97F4A7C15ULL + (hash << 6U) + (hash >> 2U);
+
+  return hash;
+}
+
+const Renderer::TextRun& Renderer::GetTextRun(std::string_view text, const asset::FontAtlas& font, uint8_t alpha) {
+  TextRunKey key{.text = std::string(text), .font = &font, .alpha = alpha};
+
+  if (auto it = text_runs_.find(key); it != text_runs_.end()) {
+    it->second.last_used_frame = frame_index_;
+    return it->second;
+  }
+
+  /* A changing text (e.g. the score) takes over an evicted run and its image instead of allocating new ones */
+  TextRun* new_run = nullptr;
+  if (!free_text_runs_.empty()) {
+    auto node = std::move(free_text_runs_.back());
+    free_text_runs_.pop_back();
+
+    node.key() = std::move(key);
+    new_run    = &text_runs_.insert(std::move(node)).position->second;
+  } else {
+    new_run = &text_runs_.try_emplace(std::move(key)).first->second;
+  }
+
+  auto& run           = *new_run;
+  run.last_used_frame = frame_index_;
+  run.image.Resize(math::Vec2u(0U));
+
+  /* Bounds of all glyphs relative to the pen position */
+  math::Vec2i min(std::numeric_limits<int32_t>::max());
+  math::Vec2i max(std::numeric_limits<int32_t>::min());
+  math::Vec2i pen(0);
+
+  for (char ch : text) {
+    const auto& ch_info = font.characters[static_cast<uint8_t>(ch)];
+
+    if (ch_info.extent_pixels.x > 0 && ch_info.extent_pixels.y > 0) {
+      const auto glyph_min = pen + ch_info.offset;
+      const auto glyph_max = glyph_min + ch_info.extent_pixels;
+
+      min = math::Vec2i(std::min(min.x, glyph_min.x), std::min(min.y, glyph_min.y));
+      max = math::Vec2i(std::max(max.x, glyph_max.x), std::max(max.y, glyph_max.y));
+    }
+
+    pen.x += font.spacing.x + ch_info.advance;
+  }
+
+  if (min.x > max.x) {
+    return run;
+  }
+
+  run.image.Resize(math::Vec2u(max - min));
+  run.offset = min;
+
+  auto run_view = run.image.CreateView();
+  std::fill(run_view.Data().begin(), run_view.Data().end(), Color(0U));
+
+  /* Glyphs are composited over each other in the same order they used to be blended into the render target */
+  auto& scaled_row = scaled_glyph_row_;
+
+  pen = math::Vec2i(0);
+  for (char ch : text) {
+    const auto& ch_info = font.characters[static_cast<uint8_t>(ch)];
+    const auto& glyph   = font.image_views[static_cast<uint8_t>(ch)];
+    const auto  origin  = math::Vec2u(pen + ch_info.offset - min);
+
+    scaled_row.resize(glyph.Extent().x);
+
+    for (uint32_t y = 0U; y < glyph.Extent().y; ++y) {
+      const Color* row = &glyph(0U, y);
+
+      if (alpha != 255U) {
+        ScaleRowPremultiplied(scaled_row.data(), row, alpha, glyph.Extent().x);
+        row = scaled_row.data();
+      }
+
+      BlendRowPremultiplied(&run_view(origin.x, origin.y + y), row, glyph.Extent().x);
+    }
+
+    pen.x += font.spacing.x + ch_info.advance;
+  }
+
+  return run;
+}
+
+void Renderer::UpdateFramebufferTransform() {
+  const float half_width  = rt_.Extent().x / 2.0f;
+  const float half_height = rt_.Extent().y / 2.0f;
+
+  /* Same mapping as ConvertNDCToFramebuffer */
+  const math::Mat3f viewport{{half_width,         0.0f,  half_width,
+                                    0.0f, -half_height, half_height,
+                                    0.0f,         0.0f,        1.0f}};
+
+  fb_proj_view_ = viewport * proj_view_;
+}
+
+void Renderer::MarkTiles(math::Vec2i min, math::Vec2i max, uint8_t flags) {
+  const auto extent = math::Vec2i(rt_.Extent());
+
+  if (max.x < 0 || max.y < 0 || min.x >= extent.x || min.y >= extent.y || min.x > max.x || min.y > max.y) {
+    return;
+  }
+
+  const auto tile_min_x = static_cast<uint32_t>(std::max(min.x, 0)) / kDamageTileSize;
+  const auto tile_min_y = static_cast<uint32_t>(std::max(min.y, 0)) / kDamageTileSize;
+  const auto tile_max_x = static_cast<uint32_t>(std::min(max.x, extent.x - 1)) / kDamageTileSize;
+  const auto tile_max_y = static_cast<uint32_t>(std::min(max.y, extent.y - 1)) / kDamageTileSize;
+
+  for (uint32_t tile_y = tile_min_y; tile_y <= tile_max_y; ++tile_y) {
+    for (uint32_t tile_x = tile_min_x; tile_x <= tile_max_x; ++tile_x) {
+      auto& tile = tiles_[tile_y * tiles_extent_.x + tile_x];
+
+      /* Most of the time the tile is already marked, so avoid the read-modify-write */
+      if ((tile.load(std::memory_order_relaxed) & flags) != flags) {
+        tile.fetch_or(flags, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+void Renderer::CollectRegions(uint8_t flags, std::vector<Region>& regions) const {
+  regions.clear();
+
+  const auto extent = rt_.Extent();
+
+  for (uint32_t tile_y = 0U; tile_y < tiles_extent_.y; ++tile_y) {
+    uint32_t tile_x = 0U;
+
+    while (tile_x < tiles_extent_.x) {
+      if ((tiles_[tile_y * tiles_extent_.x + tile_x].load(std::memory_order_relaxed) & flags) == 0U) {
+        ++tile_x;
+        continue;
+      }
+
+      const uint32_t run_begin = tile_x;
+      while (tile_x < tiles_extent_.x &&
+             (tiles_[tile_y * tiles_extent_.x + tile_x].load(std::memory_order_relaxed) & flags) != 0U) {
+        ++tile_x;
+      }
+
+      const auto offset = math::Vec2u(run_begin, tile_y) * kDamageTileSize;
+      const auto end    = math::Vec2u(std::min(tile_x * kDamageTileSize, extent.x),
+                                      std::min((tile_y + 1U) * kDamageTileSize, extent.y));
+
+      regions.push_back({.offset = offset, .extent = end - offset});
+    }
+  }
+}
+
+void Renderer::RasterizeLine(const math::Vec2f& from, const math::Vec2f& to, Color color, float thickness) {
+  const auto extent = math::Vec2i(rt_.Extent());
+
+  auto x0 = static_cast<int32_t>(std::floor(std::min(from.x, to.x) - thickness));
+  auto x1 = static_cast<int32_t>(std::ceil(std::max(from.x, to.x) + thickness));
+
+  auto y0 = static_cast<int32_t>(std::floor(std::min(from.y, to.y) - thickness));
+  auto y1 = static_cast<int32_t>(std::ceil(std::max(from.y, to.y) + thickness));
+
+  MarkTiles(math::Vec2i(x0, y0), math::Vec2i(x1, y1), kTileDrawn);
+
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, extent.x - 1);
+  y1 = std::min(y1, extent.y - 1);
+
+  std::array<uint8_t, kBlendSpanSize> coverage;
+
+  for (int32_t y = y0; y <= y1; ++y) {
+    for (int32_t span_x = x0; span_x <= x1; span_x += kBlendSpanSize) {
+      const auto span_size = std::min<size_t>(kBlendSpanSize, x1 - span_x + 1);
+
+      for (size_t i = 0U; i < span_size; ++i) {
+        coverage[i] = Coverage(CapsuleSDF(math::Vec2f(span_x + i, y), from, to, thickness));
+      }
+
+      BlendSpanPremultiplied(&rt_(span_x, y), color, coverage.data(), span_size);
+    }
+  }
+}
+
+void Renderer::CmdDrawImage(ImageView<const Color> view, const math::Vec2i& pos, uint8_t opacity) {
+  const auto extent = math::Vec2i(rt_.Extent());
+
+  const auto x0 = std::max(pos.x, 0);
+  const auto y0 = std::max(pos.y, 0);
+  const auto x1 = std::min(pos.x + static_cast<int32_t>(view.Extent().x), extent.x);
+  const auto y1 = std::min(pos.y + static_cast<int32_t>(view.Extent().y), extent.y);
+
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  MarkTiles(math::Vec2i(x0, y0), math::Vec2i(x1 - 1, y1 - 1), kTileDrawn);
+
+  if (opacity == 255U) {
+    for (int32_t y = y0; y < y1; ++y) {
+      BlendRowPremultiplied(&rt_(x0, y), &view(x0 - pos.x, y - pos.y), x1 - x0);
+    }
+
+    return;
+  }
+
+  /* Scaled in spans on the stack, so that fading images don't allocate */
+  std::array<Color, kBlendSpanSize> scaled_span;
+
+  for (int32_t y = y0; y < y1; ++y) {
+    for (int32_t span_x = x0; span_x < x1; span_x += kBlendSpanSize) {
+      const auto span_size = std::min<size_t>(kBlendSpanSize, x1 - span_x);
 
-      SetPixelBlended(pos + math::Vec2i(x, y), color);
+      ScaleRowPremultiplied(scaled_span.data(), &view(span_x - pos.x, y - pos.y), opacity, span_size);
+      BlendRowPremultiplied(&rt_(span_x, y), scaled_span.data(), span_size);
     }
   }
 }
@@ -10,30 +10,112 @@
 
 #include <Asset/FontAtlas.hpp>
 #include <Math/Mat3.hpp>
+#include <Profile/MemoryReport.hpp>
+#include <Render/BlendKernels.hpp>
 #include <Render/Color.hpp>
 #include <Render/Image.hpp>
 #include <Render/Polygon.hpp>
 
+#include <atomic>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace ra::render {
 
+/* Framebuffer space rectangle in pixels */
+struct Region {
+  math::Vec2u offset;
+  math::Vec2u extent;
+};
+
+struct ParticleInstance {
+  math::Vec2f ws_position;
+  math::Vec2f rotation{1.0f, 0.0f};  // Cosine and sine of the rotation angle
+  float       size{1.0f};
+  Color       color;  // Premultiplied alpha
+};
+
 class Renderer {
  public:
+  struct Stats {
+    uint32_t polygons_drawn{0U};
+    uint32_t polygons_culled{0U};
+    uint32_t damaged_pixels{0U};  // Known after EndFrame
+  };
+
+  /* Damage is tracked at the granularity of square tiles of this many pixels */
+  static constexpr uint32_t kDamageTileSize = 32U;
+
   void BeginFrame(ImageView<Color> render_target);
   void EndFrame();
 
   void CmdSetViewInfo(math::Mat3f proj_view, math::Mat3f inv_proj_view);
 
+  /**
+   * Colors of lines and polygons are straight alpha, they are premultiplied once per command. All blending is done with
+   * premultiplied 8-bit colors in fixed point, see BlendKernels.hpp.
+   */
   void CmdClear(Color clear_color);
   void CmdDrawLine(const math::Vec2f& ms_from, const math::Vec2f& ms_to, const math::Mat3f& transform, Color color,
                    float thickness = 1.0f);
   void CmdDrawPolygon(const Polygon& polygon, const math::Mat3f& transform);
 
+  /**
+   * Draws `shape` once per particle instance. Instead of building a transform per particle and drawing each edge
+   * separately, the shape's edges are rasterized together and every covered pixel is blended exactly once. The shape's
+   * color is ignored in favor of the instance one.
+   */
+  void CmdDrawParticles(const Polygon& shape, std::span<const ParticleInstance> particles);
+
+  /* Image must be premultiplied */
   void CmdDrawImage(ImageView<const Color> image_view, const math::Vec2f& ndc_pos, float transparency = 1.0f);
+
+  /**
+   * Text is drawn from a cache of pre-composited runs keyed by (text, font, transparency), so a string that stays the
+   * same between frames is composited once and then only blended row by row. Digits are runs of their own, so changing
+   * numbers don't add runs. Runs unused for a while are evicted and their images reused for new ones.
+   * Must only be called from the thread which records the frame.
+   */
   void CmdDrawText(std::string_view text, const math::Vec2f& ndc_pos, const asset::FontAtlas& font,
                    float transparency = 1.0f);
 
+  /**
+   * Tests world space bounding circles against the current view in one pass and writes per circle visibility flags
+   * into `visible`. The result is also accounted in the frame stats, so the function must only be called from the
+   * thread which records the frame.
+   */
+  void CullCircles(std::span<const float> ws_x, std::span<const float> ws_y, std::span<const float> ws_radius,
+                   std::span<uint8_t> visible);
+
+  /**
+   * Marks a region as changed this frame by something other than the renderer's commands (e.g. the background), so
+   * that it's reported in DamagedRegions. Unlike regions drawn by commands, it's not reported in the next frame's
+   * RestoreRegions.
+   */
+  void MarkDamaged(const Region& region);
+
+  /**
+   * Regions drawn over during the previous frame. Whatever is under the drawn objects (e.g. the background) must be
+   * restored there before drawing, the rest of the render target is left intact between frames. The whole render
+   * target is reported on the first frame and on resize. Valid after BeginFrame.
+   */
+  std::span<const Region> RestoreRegions() const;
+
+  /**
+   * Regions of the render target changed this frame, i.e. restored or drawn over, so that the presenter is able to
+   * upload only them. Valid after EndFrame.
+   */
+  std::span<const Region> DamagedRegions() const;
+
   math::Vec2f ScreenSpaceToWorld(const math::Vec2u& ss_pos) const;
 
+  const Stats& FrameStats() const;
+
+  /* Adds the damage tracking tiles and regions, and the text run cache */
+  void ReportMemory(profile::MemoryReport& report) const;
+
  private:
   inline constexpr math::Vec2f ConvertNDCToFramebuffer(const math::Vec2f& ndc) const {
     float half_width  = rt_.Extent().x / 2.0f;
@@ -63,21 +145,85 @@ class Renderer {
     return PixelCorrect(pixel) ? rt_(pixel.x, pixel.y) : Color(0U);
   }
 
-  inline void SetPixelBlended(const math::Vec2i& pixel, const math::Vec4f& normalized) {
-    math::Vec4f old{GetPixel(pixel)};
-    math::Vec4f result;
+  /* Color must be premultiplied */
+  inline void SetPixelBlended(const math::Vec2i& pixel, Color color) {
+    SetPixel(pixel, BlendPremultiplied(GetPixel(pixel), color));
+  }
 
-    result.rgb = normalized.rgb * normalized.a + old.rgb * (1.0f - normalized.a);
-    result.a   = normalized.a + old.a * (1.0f - normalized.a);
+  /* Image must be premultiplied, `opacity` is in [0, 255] */
+  void CmdDrawImage(ImageView<const Color> image_view, const math::Vec2i& pos, uint8_t opacity = 255U);
 
-    SetPixel(pixel, Color(result));
-  }
+  /* Pre-composited, premultiplied-alpha bitmap of a whole string */
+  struct TextRun {
+    Image<Color> image;
+    math::Vec2i  offset{0};  // Of the image's top-left corner relative to the pen position
+    uint64_t     last_used_frame{0U};
+  };
+
+  struct TextRunKey {
+    std::string             text;
+    const asset::FontAtlas* font{nullptr};
+    uint8_t                 alpha{0U};
 
-  void CmdDrawImage(ImageView<const Color> image_view, const math::Vec2i& pos, float transparency = 1.0f);
+    bool operator==(const TextRunKey& other) const = default;
+  };
+
+  struct TextRunKeyHash {
+    size_t operator()(const TextRunKey& key) const;
+  };
+
+  const TextRun& GetTextRun(std::string_view text, const asset::FontAtlas& font, uint8_t alpha);
+
+  void UpdateFramebufferTransform();
+
+  /**
+   * Marks framebuffer space bounds [min, max] as drawn over (kTileDrawn) or only damaged (kTileDamaged). Thread-safe,
+   * bounds are clipped to the render target.
+   */
+  void MarkTiles(math::Vec2i min, math::Vec2i max, uint8_t flags);
+
+  /* Merges runs of tiles with any of `flags` set into regions */
+  void CollectRegions(uint8_t flags, std::vector<Region>& regions) const;
+
+  /**
+   * Draws an anti-aliased line, which ends are already in framebuffer space, with a premultiplied color.
+   */
+  void RasterizeLine(const math::Vec2f& from, const math::Vec2f& to, Color color, float thickness);
+
+  /* Coverage of antialiased primitives is computed and blended in spans of this many pixels */
+  static constexpr size_t kBlendSpanSize = 64U;
+
+  /* Lines are anti-aliased and thick, so bounds are extended by this many pixels when culling */
+  static constexpr float kCullGuardBandPixels = 4.0f;
 
   ImageView<Color> rt_;
   math::Mat3f proj_view_;
   math::Mat3f inv_proj_view_;
+  math::Mat3f fb_proj_view_;  // Viewport * proj_view_, i.e. world to framebuffer space
+
+  math::Vec2f ws_view_min_{0.0f};
+  math::Vec2f ws_view_max_{0.0f};
+
+  Stats stats_;
+
+  static constexpr uint8_t kTileDrawn    = 1U << 0U;
+  static constexpr uint8_t kTileDamaged  = 1U << 1U;
+  static constexpr uint8_t kTileRestored = 1U << 2U;
+
+  /* Commands are recorded from multiple jobs at once, hence atomics */
+  math::Vec2u                       tiles_extent_{0U};
+  std::vector<std::atomic<uint8_t>> tiles_;
+  std::vector<Region>               restore_regions_;
+  std::vector<Region>               damaged_regions_;
+
+  static constexpr uint64_t kTextRunMaxUnusedFrames = 120U;
+
+  using TextRuns = std::unordered_map<TextRunKey, TextRun, TextRunKeyHash>;
+
+  uint64_t                         frame_index_{0U};
+  TextRuns                         text_runs_;
+  std::vector<TextRuns::node_type> free_text_runs_;  // Evicted runs, reused along with their images
+  std::vector<Color>               scaled_glyph_row_;
 };
 
 }  // namespace ra::render
\ No newline at end of file
@@ -3,8 +3,17 @@
 #include <memory.h>
 
 #include <stdio.h>
+#include <signal.h>
 
 #include <Game/Game.hpp>
+#include <Input/Keyboard.hpp>
+#include <Input/Recording.hpp>
+#include <Profile/AllocationTracker.hpp>
+#include <Profile/FrameStats.hpp>
+#include <Profile/Profiler.hpp>
+#include <Utils/Random.hpp>
+
+#include <random>
 
 //
 //  You are free to modify this file
@@ -16,6 +25,20 @@
 //  get_cursor_x(), get_cursor_y() - get mouse cursor position
 //  is_mouse_button_pressed(int button) - check if mouse button is pressed (0 - left button, 1 - right button)
 //  schedule_quit_game() - quit game after act()
+//
+//  Environment variables (for both the game and the headless game):
+//    RA_SEED=N              - seed of the main thread's random generator, random by default
+//    RA_RECORD_INPUT=PATH   - record per-frame input and dt into PATH on exit
+//    RA_REPLAY_INPUT=PATH   - replay a recording (including its seed and dt), quit once it ends
+//
+//  Frame, update and render time percentiles and hitches are logged every 10 seconds and on exit (see FrameStats).
+//
+//  SIGUSR2 logs a table of memory usage per component type, archetype, registry, particle system and image on the next
+//  frame (see Game::ReportMemory).
+//
+//  With RA_TRACK_ALLOCATIONS, the periodic frame time log also has the number of heap allocations per frame.
+//
+//  With RA_ENABLE_PROFILING, SIGUSR1 captures a trace of the next 300 frames into trace.json
 
 std::unique_ptr<ra::Game> g_game{nullptr};
 
@@ -26,9 +49,54 @@ ra::render::ImageView<ra::render::Color> g_render_target{
   ra::math::Vec2u(SCREEN_WIDTH, SCREEN_HEIGHT)
 };
 
+ra::input::Recording g_recording;
+const char*          g_record_path{nullptr};
+bool                 g_replaying{false};
+size_t               g_replay_frame{0U};
+
+volatile sig_atomic_t g_memory_report_requested{0};
+
+static void RequestMemoryReport(int)
+{
+  g_memory_report_requested = 1;
+}
+
+#if defined(RA_ENABLE_PROFILING)
+static void RequestTrace(int)
+{
+  ra::profile::Profiler::Instance().RequestTrace();
+}
+#endif
+
 // initialize game data in this function
 void initialize()
 {
+#if defined(RA_ENABLE_PROFILING)
+  RA_PROFILE_THREAD("Main");
+  signal(SIGUSR1, &RequestTrace);
+#endif
+
+  signal(SIGUSR2, &RequestMemoryReport);
+
+  uint64_t seed = std::random_device{}();
+  if (const char* seed_str = getenv("RA_SEED")) {
+    seed = strtoull(seed_str, nullptr, 10);
+  }
+
+  if (const char* replay_path = getenv("RA_REPLAY_INPUT")) {
+    if (auto recording = ra::input::LoadRecording(replay_path)) {
+      g_recording = std::move(*recording);
+      g_replaying = true;
+      seed        = g_recording.seed;
+    }
+  } else if ((g_record_path = getenv("RA_RECORD_INPUT"))) {
+    g_recording.seed = seed;
+  }
+
+  /* Everything random in the simulation comes from the main thread's generator */
+  RA_LOG_INFO("Random seed is %llu", static_cast<unsigned long long>(seed));
+  ra::utils::Random::Instance().Seed(seed);
+
   g_game = std::make_unique<ra::Game>();
   g_game->StartNew();
 }
@@ -37,14 +105,59 @@ void initialize()
 // dt - time elapsed since the previous update (in seconds)
 void act(float dt)
 {
-  if (is_key_pressed(VK_ESCAPE))
+  if (g_replaying) {
+    if (g_replay_frame == g_recording.frames.size()) {
+      ra::input::SetPlaybackFrame(nullptr);
+      schedule_quit_game();
+      return;
+    }
+
+    const auto& frame = g_recording.frames[g_replay_frame++];
+    ra::input::SetPlaybackFrame(&frame);
+    dt = frame.dt;
+  } else if (g_record_path) {
+    g_recording.frames.push_back(ra::input::CaptureFrameInput(dt));
+  }
+
+  auto& frame_stats = ra::profile::FrameStats::Instance();
+  frame_stats.BeginFrame();
+
+  if (ra::input::CheckKey(ra::input::Key::Esc))
     schedule_quit_game();
 
+  if (g_memory_report_requested) {
+    g_memory_report_requested = 0;
+
+    ra::profile::MemoryReport report;
+    g_game->ReportMemory(report);
+    report.Print();
+  }
+
+  const uint64_t update_start = ra::profile::NowNs();
   g_game->Update(dt);
+  frame_stats.Record(ra::profile::FrameStage::Update, ra::profile::NowNs() - update_start);
 
   static uint32_t fif = 0U;
+  static size_t   overflowed_bursts = 0U;
+  overflowed_bursts += g_game->OverflowedParticleBursts();
+
   if (fif >= 60U) {
-    RA_LOG_INFO("Frame time is %.2f ms", dt * 1e3);
+    const auto& stats = g_game->RenderStats();
+    RA_LOG_INFO("Frame time is %.2f ms (polygons drawn %u, culled %u, damaged pixels %u)", dt * 1e3,
+                stats.polygons_drawn, stats.polygons_culled, stats.damaged_pixels);
+
+    if (ra::profile::AllocationTracker::Enabled()) {
+      static uint64_t last_allocations = 0U;
+
+      const uint64_t allocations = ra::profile::AllocationTracker::Counts().allocations;
+      RA_LOG_INFO("Heap allocations per frame %.1f", static_cast<double>(allocations - last_allocations) / (fif + 1U));
+      last_allocations = allocations;
+    }
+
+    if (overflowed_bursts > 0U) {
+      RA_LOG_WARN("%zu particle bursts didn't fit into the pending bursts buffer", overflowed_bursts);
+      overflowed_bursts = 0U;
+    }
 
     fif = 0U;
   } else {
@@ -56,11 +169,20 @@ void act(float dt)
 // uint32_t buffer[SCREEN_HEIGHT][SCREEN_WIDTH] - is an array of 32-bit colors (8 bits per R, G, B)
 void draw()
 {
+  const uint64_t render_start = ra::profile::NowNs();
   g_game->Render(g_render_target);
+  ra::profile::FrameStats::Instance().Record(ra::profile::FrameStage::Render, ra::profile::NowNs() - render_start);
 }
 
 // free game data in this function
 void finalize()
 {
   g_game.reset();
+
+  RA_PROFILE_FLUSH();
+  ra::profile::FrameStats::Instance().ReportTotal();
+
+  if (g_record_path) {
+    ra::input::SaveRecording(g_record_path, g_recording);
+  }
 }
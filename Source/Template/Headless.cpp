@@ -0,0 +1,807 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file Headless.cpp
+ * @date 2024-08-16
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+//
+//  Platform layer without a display, implements Engine.h in place of Engine.cpp. The game runs with a synthetic clock
+//  for a fixed number of frames, renders into the same `buffer`, reads input from a script and reports frame timings
+//  on exit.
+//
+//  Usage: retro-asteroids-headless [--frames N] [--dt SECONDS] [--input SCRIPT] [--min-polygons N]
+//                                  [--frame-times CSV] [--frame-stats JSON] [--memory JSON] [--trace PATH]
+//                                  [--trace-frames N] [--check-allocations WARMUP_FRAMES]
+//         retro-asteroids-headless --stress <UFOS:PROJECTILES:EMITTERS[,...]|sweep|sweep-large> [--stress-frames N]
+//                                  [--dt SECONDS] [--stress-csv CSV]
+//
+//  --frames 0 runs until the game quits, which is the default when replaying a recording (see RA_REPLAY_INPUT in
+//  Game.cpp). --frame-times writes wall clock durations of each frame, so that runs of different builds on the same
+//  recording can be compared (see Tools/compare_frame_times.py).
+//
+//  --frame-stats writes frame, update and render time percentiles of the run and the number of hitches, i.e. frames
+//  longer than twice --dt, as JSON (see FrameStats), so that tail latency can be checked against a fixed limit (see
+//  Tools/check_frame_stats.py).
+//
+//  --memory prints memory usage per component type, archetype, registry, particle system and image at the end of the
+//  run and writes it as JSON (see Game::ReportMemory). In stress mode that's the end of the last scene.
+//
+//  --check-allocations, only in builds with RA_TRACK_ALLOCATIONS, counts heap allocations of every frame after the
+//  first WARMUP_FRAMES and fails (exit code 1) if there were any, printing the call sites they came from. In stress
+//  mode every scene is checked separately. Containers growing past their previous peak, the first time a string is drawn
+//  and frames that start a new game allocate, so the scene should reach its peak size during the warm-up, e.g.
+//  --stress 50:200:5 --stress-frames 900 --check-allocations 120.
+//
+//  --trace captures a Chrome trace (chrome://tracing, ui.perfetto.dev) of the first --trace-frames frames (300 by
+//  default) into PATH, only in builds with RA_ENABLE_PROFILING. It works in stress mode as well.
+//
+//  --min-polygons fails the run (exit code 1) if a frame draws fewer than N polygons, so that a perf workload can't
+//  empty out and measure nothing (see Tools/Workloads). It's 1 for the built-in script, which is meant to keep a live
+//  scene, and 0 (off) for --input scripts and RA_REPLAY_INPUT, which may well end in an empty scene or a menu.
+//
+//  Input script is a text file with one event per line, events are applied before act() of the given frame:
+//    <frame> key <esc|space|left|up|right|down|enter> <down|up>
+//    <frame> button <0-4> <down|up>
+//    <frame> cursor <x> <y>
+//    <frame> quit
+//  Empty lines and lines starting with '#' are skipped.
+//
+//  Stress mode (--stress or RA_STRESS) skips the regular game and instead runs a scene of each given size for
+//  --stress-frames frames, with an invulnerable player firing continuously (see Game::StartStress). Every scene starts
+//  from the same seed (RA_SEED, 0 by default). Mean, p99 and max wall clock time of every GameSystem per scene size are
+//  printed and written to --stress-csv (stress.csv by default), one row per (size, system), for plotting scaling curves.
+//  Collisions are tested between all pairs of colliders, so sizes beyond a few thousand entities take long to run:
+//  "sweep" stops at 2200 colliders, while the opt-in "sweep-large" goes up to 55000 (5000 UFOs, 50000 projectiles),
+//  where collisions alone take tens of seconds per frame, so it runs kLargeSweepFrames frames unless --stress-frames
+//  is given.
+//
+
+#include <Template/Engine.h>
+
+#include <Game/Game.hpp>
+#include <Profile/AllocationTracker.hpp>
+#include <Profile/FrameStats.hpp>
+#include <Profile/MemoryReport.hpp>
+#include <Profile/Profiler.hpp>
+#include <Utils/Log.hpp>
+#include <Utils/Random.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+uint32_t buffer[SCREEN_HEIGHT][SCREEN_WIDTH] = {0};
+
+namespace {
+
+constexpr uint32_t kMouseButtonsCount   = 5U;
+constexpr uint32_t kDefaultFrames       = 3600U;
+constexpr float    kDefaultDt           = 1.0f / 60.0f;
+constexpr uint32_t kDefaultStressFrames = 120U;
+constexpr uint32_t kLargeSweepFrames    = 5U;
+
+/* Scene sizes of --stress sweep */
+constexpr ra::StressConfig kDefaultSweep[] = {
+  {.ufos = 10U,  .projectiles = 100U,  .emitters = 1U},
+  {.ufos = 50U,  .projectiles = 500U,  .emitters = 5U},
+  {.ufos = 100U, .projectiles = 1000U, .emitters = 10U},
+  {.ufos = 200U, .projectiles = 2000U, .emitters = 20U},
+};
+
+/* Scene sizes of --stress sweep-large, continuing kDefaultSweep up to the scale where all-pairs collisions dominate */
+constexpr ra::StressConfig kLargeSweep[] = {
+  {.ufos = 500U,  .projectiles = 5000U,  .emitters = 50U},
+  {.ufos = 1000U, .projectiles = 10000U, .emitters = 100U},
+  {.ufos = 2000U, .projectiles = 20000U, .emitters = 200U},
+  {.ufos = 5000U, .projectiles = 50000U, .emitters = 500U},
+};
+
+/* Used when no script is given: fly around, keep shooting and start a new game every 10 seconds if it's over */
+constexpr const char* kDefaultScript = R"(
+0 cursor 512 200
+0 button 0 down
+0 key up down
+60 key up up
+120 key left down
+180 key left up
+300 key down down
+330 key down up
+600 key enter down
+601 key enter up
+1200 key enter down
+1201 key enter up
+1800 key enter down
+1801 key enter up
+2400 key enter down
+2401 key enter up
+3000 key enter down
+3001 key enter up
+)";
+
+struct InputState {
+  bool keys[VK__COUNT]{false};
+  bool mouse_buttons[kMouseButtonsCount]{false};
+  int  cursor_x{0};
+  int  cursor_y{0};
+  bool quit{false};
+};
+
+struct InputEvent {
+  enum class Type : uint32_t {
+    Key,
+    Button,
+    Cursor,
+    Quit
+  };
+
+  uint32_t frame{0U};
+  Type     type{Type::Quit};
+  int      code{0};
+  int      x{0};
+  int      y{0};
+  bool     pressed{false};
+};
+
+InputState g_input;
+
+}  // namespace
+
+/* Defined in Game.cpp */
+extern std::unique_ptr<ra::Game> g_game;
+
+bool is_key_pressed(int button_vk_code) {
+  if (static_cast<unsigned>(button_vk_code) >= VK__COUNT) {
+    return false;
+  }
+
+  return g_input.keys[button_vk_code];
+}
+
+bool is_mouse_button_pressed(int mouse_button) {
+  if (static_cast<unsigned>(mouse_button) >= kMouseButtonsCount) {
+    return false;
+  }
+
+  return g_input.mouse_buttons[mouse_button];
+}
+
+int get_cursor_x() { return g_input.cursor_x; }
+int get_cursor_y() { return g_input.cursor_y; }
+
+void schedule_quit_game() { g_input.quit = true; }
+
+namespace {
+
+int ParseKey(std::string_view name) {
+  constexpr std::pair<std::string_view, int> kKeys[] = {
+    {"esc", VK_ESCAPE}, {"space", VK_SPACE}, {"left", VK_LEFT}, {"up", VK_UP},
+    {"right", VK_RIGHT}, {"down", VK_DOWN}, {"enter", VK_RETURN}
+  };
+
+  for (const auto& [key_name, code] : kKeys) {
+    if (key_name == name) {
+      return code;
+    }
+  }
+
+  return -1;
+}
+
+bool ParseScript(std::istream& script, std::vector<InputEvent>& events) {
+  std::string line;
+  uint32_t    line_number = 0U;
+
+  while (std::getline(script, line)) {
+    ++line_number;
+
+    std::istringstream tokens(line);
+    std::string        frame;
+    std::string        type;
+
+    if (!(tokens >> frame) || frame[0] == '#') {
+      continue;
+    }
+
+    InputEvent event;
+    bool       valid = (tokens >> type) &&
+                 std::from_chars(frame.data(), frame.data() + frame.size(), event.frame).ec == std::errc{};
+
+    std::string name;
+    std::string state;
+
+    if (valid && type == "key") {
+      event.type = InputEvent::Type::Key;
+      valid      = (tokens >> name >> state) && (event.code = ParseKey(name)) >= 0;
+    } else if (valid && type == "button") {
+      event.type = InputEvent::Type::Button;
+      valid      = (tokens >> event.code >> state) && static_cast<unsigned>(event.code) < kMouseButtonsCount;
+    } else if (valid && type == "cursor") {
+      event.type = InputEvent::Type::Cursor;
+      valid      = static_cast<bool>(tokens >> event.x >> event.y);
+    } else if (valid && type == "quit") {
+      event.type = InputEvent::Type::Quit;
+    } else {
+      valid = false;
+    }
+
+    if (valid && (event.type == InputEvent::Type::Key || event.type == InputEvent::Type::Button)) {
+      valid         = (state == "down" || state == "up");
+      event.pressed = (state == "down");
+    }
+
+    if (!valid) {
+      RA_LOG_ERROR("Invalid input script event at line %u: \"%s\"", line_number, line.c_str());
+      return false;
+    }
+
+    events.push_back(event);
+  }
+
+  /* Events of the same frame keep their relative order */
+  std::stable_sort(events.begin(), events.end(), [](const auto& lhs, const auto& rhs) { return lhs.frame < rhs.frame; });
+
+  return true;
+}
+
+void ApplyEvent(const InputEvent& event) {
+  switch (event.type) {
+    case InputEvent::Type::Key:    { g_input.keys[event.code] = event.pressed; break; }
+    case InputEvent::Type::Button: { g_input.mouse_buttons[event.code] = event.pressed; break; }
+    case InputEvent::Type::Cursor: { g_input.cursor_x = event.x; g_input.cursor_y = event.y; break; }
+    case InputEvent::Type::Quit:   { g_input.quit = true; break; }
+  }
+}
+
+struct Options {
+  uint32_t    frames{kDefaultFrames};
+  float       dt{kDefaultDt};
+  std::string input_script;
+  uint32_t    min_polygons{0U};
+  bool        min_polygons_set{false};
+  std::string frame_times_csv;
+  std::string frame_stats_json;
+  std::string memory_json;
+  bool        check_allocations{false};
+  uint32_t    allocations_warmup_frames{0U};
+  std::string trace;
+  uint32_t    trace_frames{ra::profile::Profiler::kDefaultTraceFrames};
+
+  std::vector<ra::StressConfig> stress;
+  bool                          stress_large{false};
+  uint32_t                      stress_frames{kDefaultStressFrames};
+  bool                          stress_frames_set{false};
+  std::string                   stress_csv{"stress.csv"};
+};
+
+/* Parses "sweep", "sweep-large" or a comma separated list of UFOS:PROJECTILES:EMITTERS */
+bool ParseStress(std::string_view value, Options& options) {
+  auto& configs = options.stress;
+
+  if (value == "sweep") {
+    configs.insert(configs.end(), std::begin(kDefaultSweep), std::end(kDefaultSweep));
+    return true;
+  }
+
+  if (value == "sweep-large") {
+    configs.insert(configs.end(), std::begin(kLargeSweep), std::end(kLargeSweep));
+    options.stress_large = true;
+    return true;
+  }
+
+  while (!value.empty()) {
+    const auto config_end = std::min(value.find(','), value.size());
+    const auto config     = value.substr(0U, config_end);
+
+    ra::StressConfig parsed;
+    uint32_t*        fields[] = {&parsed.ufos, &parsed.projectiles, &parsed.emitters};
+
+    const char* it  = config.data();
+    const char* end = config.data() + config.size();
+    for (uint32_t field = 0U; field < std::size(fields); ++field) {
+      auto [next, ec] = std::from_chars(it, end, *fields[field]);
+      if (ec != std::errc{} || (field + 1U < std::size(fields) ? (next == end || *next != ':') : next != end)) {
+        RA_LOG_ERROR("Invalid stress scene \"%.*s\", expected UFOS:PROJECTILES:EMITTERS",
+                     static_cast<int>(config.size()), config.data());
+        return false;
+      }
+
+      it = next + 1;
+    }
+
+    configs.push_back(parsed);
+    value.remove_prefix(std::min(config_end + 1U, value.size()));
+  }
+
+  return true;
+}
+
+bool ParseOptions(int argc, const char** argv, Options& options) {
+  if (std::getenv("RA_REPLAY_INPUT") != nullptr) {
+    options.frames = 0U;
+  }
+
+  if (const char* stress = std::getenv("RA_STRESS"); stress != nullptr && !ParseStress(stress, options)) {
+    return false;
+  }
+
+  for (int arg = 1; arg < argc; ++arg) {
+    const std::string_view name  = argv[arg];
+    const char*            value = (arg + 1 < argc) ? argv[arg + 1] : nullptr;
+
+    if (value == nullptr) {
+      RA_LOG_ERROR("Missing value of option \"%s\"", argv[arg]);
+      return false;
+    }
+
+    if (name == "--frames") {
+      options.frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (name == "--dt") {
+      options.dt = std::strtof(value, nullptr);
+    } else if (name == "--input") {
+      options.input_script = value;
+    } else if (name == "--min-polygons") {
+      options.min_polygons     = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+      options.min_polygons_set = true;
+    } else if (name == "--frame-times") {
+      options.frame_times_csv = value;
+    } else if (name == "--frame-stats") {
+      options.frame_stats_json = value;
+    } else if (name == "--memory") {
+      options.memory_json = value;
+    } else if (name == "--check-allocations") {
+      options.check_allocations         = true;
+      options.allocations_warmup_frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (name == "--trace") {
+      options.trace = value;
+    } else if (name == "--trace-frames") {
+      options.trace_frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (name == "--stress") {
+      if (!ParseStress(value, options)) {
+        return false;
+      }
+    } else if (name == "--stress-frames") {
+      options.stress_frames     = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+      options.stress_frames_set = true;
+    } else if (name == "--stress-csv") {
+      options.stress_csv = value;
+    } else {
+      RA_LOG_ERROR("Unknown option \"%s\"", argv[arg]);
+      return false;
+    }
+
+    ++arg;
+  }
+
+  if (options.dt <= 0.0f) {
+    RA_LOG_ERROR("Frame time must be positive, got %f", options.dt);
+    return false;
+  }
+
+  if (options.stress_large && !options.stress_frames_set) {
+    options.stress_frames = kLargeSweepFrames;
+  }
+
+  if (!options.min_polygons_set && options.input_script.empty() && std::getenv("RA_REPLAY_INPUT") == nullptr) {
+    options.min_polygons = 1U;
+  }
+
+  if (options.check_allocations && !ra::profile::AllocationTracker::Enabled()) {
+    RA_LOG_ERROR("Built without RA_TRACK_ALLOCATIONS, allocations can't be checked");
+    return false;
+  }
+
+  return true;
+}
+
+/* Wall clock durations of every frame's act() and draw() in nanoseconds */
+struct FrameTimings {
+  std::vector<double> act;
+  std::vector<double> draw;
+  std::vector<double> frame;
+};
+
+void WriteFrameTimes(const std::string& filepath, const FrameTimings& timings) {
+  std::ofstream fs(filepath, std::ios::out);
+  if (!fs.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", filepath.c_str());
+    return;
+  }
+
+  fs << "frame,act_ns,draw_ns,frame_ns\n";
+  for (size_t frame = 0U; frame < timings.frame.size(); ++frame) {
+    fs << frame << ',' << static_cast<uint64_t>(timings.act[frame]) << ',' << static_cast<uint64_t>(timings.draw[frame])
+       << ',' << static_cast<uint64_t>(timings.frame[frame]) << '\n';
+  }
+}
+
+/* Allocations of every frame after the warm-up, returns whether there were none */
+bool CheckAllocations(const std::vector<uint64_t>& frame_allocations, uint32_t warmup_frames) {
+  uint64_t total           = 0U;
+  uint64_t max             = 0U;
+  size_t   frames_with_any = 0U;
+  size_t   first_frame     = 0U;
+
+  for (size_t frame = 0U; frame < frame_allocations.size(); ++frame) {
+    if (frame_allocations[frame] > 0U && frames_with_any++ == 0U) {
+      first_frame = warmup_frames + frame;
+    }
+
+    total += frame_allocations[frame];
+    max    = std::max(max, frame_allocations[frame]);
+  }
+
+  if (total == 0U) {
+    RA_LOG_INFO("No heap allocations in %zu frames after the first %u", frame_allocations.size(), warmup_frames);
+    return true;
+  }
+
+  RA_LOG_ERROR("%llu heap allocations in %zu of %zu frames after the first %u (up to %llu per frame, first in "
+               "frame %zu)",
+               static_cast<unsigned long long>(total), frames_with_any, frame_allocations.size(), warmup_frames,
+               static_cast<unsigned long long>(max), first_frame);
+  ra::profile::AllocationTracker::PrintCallSites();
+
+  return false;
+}
+
+void PrintTimings(const char* name, std::vector<double> timings) {
+  if (timings.empty()) {
+    return;
+  }
+
+  std::sort(timings.begin(), timings.end());
+
+  double sum = 0.0;
+  for (double timing : timings) {
+    sum += timing;
+  }
+
+  const auto percentile = [&](double p) {
+    return timings[std::min(timings.size() - 1U, static_cast<size_t>(p * timings.size()))];
+  };
+
+  std::printf("%-8s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, timings.front() * 1e-6, sum / timings.size() * 1e-6,
+              percentile(0.5) * 1e-6, percentile(0.99) * 1e-6, timings.back() * 1e-6);
+}
+
+/* Timings of every frame of a stress scene, per GameSystem plus the whole frame */
+struct StressResult {
+  ra::StressConfig               config;
+  std::vector<ra::SystemTimings> systems;
+  std::vector<double>            frame;
+  size_t                         overflowed_bursts{0U};
+};
+
+struct TimingSummary {
+  double mean{0.0};
+  double p99{0.0};
+  double max{0.0};
+};
+
+TimingSummary Summarize(std::vector<double> timings) {
+  if (timings.empty()) {
+    return {};
+  }
+
+  std::sort(timings.begin(), timings.end());
+
+  double sum = 0.0;
+  for (double timing : timings) {
+    sum += timing;
+  }
+
+  return {.mean = sum / timings.size(),
+          .p99  = timings[std::min(timings.size() - 1U, static_cast<size_t>(0.99 * timings.size()))],
+          .max  = timings.back()};
+}
+
+/**
+ * Memory of the scene's game is reported at the end into `memory`, unless it's null. Heap allocations of every frame
+ * after `allocations_warmup` are appended to `frame_allocations`, unless it's null.
+ */
+StressResult RunStressScene(const ra::StressConfig& config, uint32_t frames, float dt, ra::profile::MemoryReport* memory,
+                            uint32_t allocations_warmup, std::vector<uint64_t>* frame_allocations) {
+  using Clock = std::chrono::steady_clock;
+
+  ra::render::ImageView<ra::render::Color> render_target{
+    reinterpret_cast<ra::render::Color*>(buffer),
+    ra::math::Vec2u(SCREEN_WIDTH, SCREEN_HEIGHT),
+    ra::math::Vec2u(0U),
+    ra::math::Vec2u(SCREEN_WIDTH, SCREEN_HEIGHT)
+  };
+
+  uint64_t seed = 0U;
+  if (const char* seed_str = std::getenv("RA_SEED")) {
+    seed = std::strtoull(seed_str, nullptr, 10);
+  }
+  ra::utils::Random::Instance().Seed(seed);
+
+  /* Continuous fire, aiming up */
+  g_input                  = InputState{};
+  g_input.mouse_buttons[0] = true;
+  g_input.cursor_x         = SCREEN_WIDTH / 2;
+  g_input.cursor_y         = SCREEN_HEIGHT / 4;
+
+  StressResult result;
+  result.config = config;
+  result.systems.reserve(frames);
+  result.frame.reserve(frames);
+
+  auto game = std::make_unique<ra::Game>();
+  game->StartStress(config);
+
+  for (uint32_t frame = 0U; frame < frames; ++frame) {
+    const bool check_allocations = frame_allocations != nullptr && frame >= allocations_warmup;
+    if (check_allocations && frame == allocations_warmup) {
+      ra::profile::AllocationTracker::CaptureCallSites(true);
+    }
+
+    const uint64_t allocations = ra::profile::AllocationTracker::Counts().allocations;
+    const auto     start       = Clock::now();
+
+    game->Update(dt);
+    game->Render(render_target);
+
+    result.frame.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    result.systems.push_back(game->LastFrameTimings());
+    result.overflowed_bursts += game->OverflowedParticleBursts();
+
+    if (check_allocations) {
+      frame_allocations->push_back(ra::profile::AllocationTracker::Counts().allocations - allocations);
+    }
+  }
+
+  ra::profile::AllocationTracker::CaptureCallSites(false);
+
+  if (memory != nullptr) {
+    game->ReportMemory(*memory);
+  }
+
+  return result;
+}
+
+TimingSummary SummarizeSystem(const StressResult& result, size_t system) {
+  std::vector<double> timings;
+  timings.reserve(result.systems.size());
+
+  for (const auto& frame : result.systems) {
+    timings.push_back(frame[system]);
+  }
+
+  return Summarize(std::move(timings));
+}
+
+int RunStress(const Options& options) {
+  constexpr size_t kSystemsCount = static_cast<size_t>(ra::GameSystem::Count);
+
+  std::ofstream csv(options.stress_csv, std::ios::out);
+  if (!csv.is_open()) {
+    RA_LOG_ERROR("Failed to open file \"%s\"", options.stress_csv.c_str());
+    return 1;
+  }
+
+  csv << "ufos,projectiles,emitters,system,mean_ms,p99_ms,max_ms\n";
+
+  const auto write_row = [&](const ra::StressConfig& config, const char* system, const TimingSummary& summary) {
+    char row[160];
+    std::snprintf(row, sizeof(row), "%u,%u,%u,%s,%.4f,%.4f,%.4f\n", config.ufos, config.projectiles, config.emitters,
+                  system, summary.mean * 1e-6, summary.p99 * 1e-6, summary.max * 1e-6);
+    csv << row;
+  };
+
+  ra::profile::MemoryReport memory;
+  bool                      allocations_ok = true;
+
+  for (const auto& config : options.stress) {
+    std::vector<uint64_t> frame_allocations;
+    frame_allocations.reserve(options.stress_frames);
+
+    const bool last   = (&config == &options.stress.back());
+    const auto result = RunStressScene(config, options.stress_frames, options.dt,
+                                       (last && !options.memory_json.empty()) ? &memory : nullptr,
+                                       options.allocations_warmup_frames,
+                                       options.check_allocations ? &frame_allocations : nullptr);
+
+    std::printf("\nStress scene: %u UFOs, %u projectiles, %u emitters, %u frames\n", config.ufos, config.projectiles,
+                config.emitters, options.stress_frames);
+    std::printf("%-18s %10s %10s %10s\n", "ms", "mean", "p99", "max");
+
+    for (size_t system = 0U; system < kSystemsCount; ++system) {
+      const auto  summary = SummarizeSystem(result, system);
+      const char* name    = ra::ToString(static_cast<ra::GameSystem>(system));
+
+      std::printf("%-18s %10.3f %10.3f %10.3f\n", name, summary.mean * 1e-6, summary.p99 * 1e-6, summary.max * 1e-6);
+      write_row(config, name, summary);
+    }
+
+    const auto frame = Summarize(result.frame);
+    std::printf("%-18s %10.3f %10.3f %10.3f\n", "frame", frame.mean * 1e-6, frame.p99 * 1e-6, frame.max * 1e-6);
+    write_row(config, "frame", frame);
+
+    if (result.overflowed_bursts > 0U) {
+      RA_LOG_WARN("%zu particle bursts took the locked overflow path", result.overflowed_bursts);
+    }
+
+    if (options.check_allocations) {
+      allocations_ok &= CheckAllocations(frame_allocations, options.allocations_warmup_frames);
+    }
+  }
+
+  RA_LOG_INFO("Saved stress timings \"%s\"", options.stress_csv.c_str());
+  RA_PROFILE_FLUSH();
+
+  if (!options.memory_json.empty()) {
+    memory.Print();
+    if (!memory.WriteJson(options.memory_json)) {
+      return 1;
+    }
+  }
+
+  return allocations_ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  if (!options.trace.empty()) {
+#if defined(RA_ENABLE_PROFILING)
+    RA_PROFILE_THREAD("Main");
+    ra::profile::Profiler::Instance().CaptureTrace(options.trace, options.trace_frames);
+#else
+    RA_LOG_WARN("Built without RA_ENABLE_PROFILING, no trace is captured");
+#endif
+  }
+
+  if (!options.stress.empty()) {
+    return RunStress(options);
+  }
+
+  std::vector<InputEvent> events;
+
+  if (options.input_script.empty()) {
+    std::istringstream script(kDefaultScript);
+    ParseScript(script, events);
+  } else {
+    std::ifstream script(options.input_script);
+    if (!script.is_open()) {
+      RA_LOG_ERROR("Failed to open input script \"%s\"", options.input_script.c_str());
+      return 1;
+    }
+
+    if (!ParseScript(script, events)) {
+      return 1;
+    }
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  const auto to_ns = [](Clock::duration duration) { return std::chrono::duration<double, std::nano>(duration).count(); };
+
+  FrameTimings timings;
+  timings.act.reserve(options.frames);
+  timings.draw.reserve(options.frames);
+  timings.frame.reserve(options.frames);
+
+  std::vector<uint64_t> frame_allocations;
+  frame_allocations.reserve(options.frames);
+
+  /* The synthetic frame time is the budget, as if the game had to keep up with it in real time */
+  ra::profile::FrameStats::Instance().SetBudget(static_cast<uint64_t>(options.dt * 1e9));
+
+  initialize();
+
+  const auto start             = Clock::now();
+  auto       next_event        = events.begin();
+  uint32_t   frame             = 0U;
+  uint32_t   empty_frames      = 0U;
+  uint32_t   sparse_frames     = 0U;
+  size_t     overflowed_bursts = 0U;
+
+  for (; options.frames == 0U || frame < options.frames; ++frame) {
+    for (; next_event != events.end() && next_event->frame <= frame; ++next_event) {
+      ApplyEvent(*next_event);
+    }
+
+    const bool check_allocations = options.check_allocations && frame >= options.allocations_warmup_frames;
+    if (check_allocations && frame == options.allocations_warmup_frames) {
+      ra::profile::AllocationTracker::CaptureCallSites(true);
+    }
+
+    const uint64_t allocations = ra::profile::AllocationTracker::Counts().allocations;
+
+    const auto act_start = Clock::now();
+    act(options.dt);
+    const auto act_end = Clock::now();
+
+    if (g_input.quit) {
+      break;
+    }
+
+    draw();
+    const auto draw_end = Clock::now();
+
+    const uint32_t polygons_drawn = g_game->RenderStats().polygons_drawn;
+    if (polygons_drawn == 0U) {
+      ++empty_frames;
+    }
+
+    if (polygons_drawn < options.min_polygons) {
+      ++sparse_frames;
+    }
+
+    overflowed_bursts += g_game->OverflowedParticleBursts();
+
+    if (check_allocations) {
+      frame_allocations.push_back(ra::profile::AllocationTracker::Counts().allocations - allocations);
+    }
+
+    timings.act.push_back(to_ns(act_end - act_start));
+    timings.draw.push_back(to_ns(draw_end - act_end));
+    timings.frame.push_back(to_ns(draw_end - act_start));
+  }
+
+  const double wall_ns = to_ns(Clock::now() - start);
+
+  ra::profile::AllocationTracker::CaptureCallSites(false);
+
+  /* Taken before finalize destroys the game */
+  bool memory_saved = true;
+  if (!options.memory_json.empty()) {
+    ra::profile::MemoryReport report;
+    g_game->ReportMemory(report);
+    report.Print();
+
+    memory_saved = report.WriteJson(options.memory_json);
+  }
+
+  finalize();
+
+  if (!options.frame_times_csv.empty()) {
+    WriteFrameTimes(options.frame_times_csv, timings);
+  }
+
+  if (!options.frame_stats_json.empty() && !ra::profile::FrameStats::Instance().WriteJson(options.frame_stats_json)) {
+    return 1;
+  }
+
+  if (!memory_saved) {
+    return 1;
+  }
+
+  std::printf("\nHeadless run: %u frames in %.2f s (%.1f fps), %u without polygons\n", frame, wall_ns * 1e-9,
+              frame / (wall_ns * 1e-9), empty_frames);
+  std::printf("%-8s %10s %10s %10s %10s %10s\n", "ms", "min", "avg", "p50", "p99", "max");
+  PrintTimings("act", std::move(timings.act));
+  PrintTimings("draw", std::move(timings.draw));
+  PrintTimings("frame", std::move(timings.frame));
+
+  if (overflowed_bursts > 0U) {
+    RA_LOG_WARN("%zu particle bursts took the locked overflow path", overflowed_bursts);
+  }
+
+  /* A perf workload whose scene emptied out would measure nothing */
+  if (sparse_frames > 0U) {
+    RA_LOG_ERROR("%u of %u frames drew fewer than %u polygons", sparse_frames, frame, options.min_polygons);
+    return 1;
+  }
+
+  if (options.check_allocations && !CheckAllocations(frame_allocations, options.allocations_warmup_frames)) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file AppendBuffer.hpp
+ * @date 2024-08-10
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <span>
+
+namespace ra::utils {
+
+/**
+ * Fixed capacity multi-producer append-only buffer. Producers reserve slots with a single atomic increment, there are
+ * no locks. Consuming (View and Clear) is only valid after a synchronization point with all producers, e.g. once the
+ * jobs that append have been waited for.
+ */
+template <typename T, size_t Capacity>
+class AppendBuffer {
+ public:
+  /** @return false if the buffer is full, the value is dropped in this case. */
+  bool Push(const T& value);
+
+  std::span<const T> View() const;
+  void Clear();
+
+ private:
+  std::array<T, Capacity> values_;
+  std::atomic<size_t>     size_{0U};
+};
+
+template <typename T, size_t Capacity>
+bool AppendBuffer<T, Capacity>::Push(const T& value) {
+  const size_t slot = size_.fetch_add(1U, std::memory_order_relaxed);
+  if (slot >= Capacity) {
+    return false;
+  }
+
+  values_[slot] = value;
+  return true;
+}
+
+template <typename T, size_t Capacity>
+std::span<const T> AppendBuffer<T, Capacity>::View() const {
+  const size_t size = size_.load(std::memory_order_relaxed);
+  return std::span<const T>(values_.data(), size < Capacity ? size : Capacity);
+}
+
+template <typename T, size_t Capacity>
+void AppendBuffer<T, Capacity>::Clear() {
+  size_.store(0U, std::memory_order_relaxed);
+}
+
+}  // namespace ra::utils
@@ -8,16 +8,25 @@
 
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
-#include <deque>
 #include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace ra::utils {
 
+/**
+ * Values are kept in a ring buffer, which grows when full and never shrinks, so once it has grown to the largest number
+ * of values queued at once, pushing and popping don't allocate.
+ */
 template <typename T>
 class BlockingQueue {
  public:
+  /* Makes room for `capacity` values without further allocations */
+  void Reserve(size_t capacity);
+
   void Push(T value);
 
   std::optional<T> Pop();
@@ -25,19 +34,38 @@ class BlockingQueue {
   void Close();
 
  private:
+  /* Moves values into a buffer of `capacity`, unwrapped so that the oldest one is first, must be called locked */
+  void Grow(size_t capacity);
+
   std::mutex              mutex_;
   std::condition_variable cv_not_empty_;
 
   bool                    closed_{false};
-  std::deque<T>           data_;
+  std::vector<T>          data_;
+  size_t                  head_{0U};
+  size_t                  size_{0U};
 };
 
+template <typename T>
+void BlockingQueue<T>::Reserve(size_t capacity) {
+  std::lock_guard lock(mutex_);
+
+  if (capacity > data_.size()) {
+    Grow(capacity);
+  }
+}
+
 template <typename T>
 void BlockingQueue<T>::Push(T value) {
   std::lock_guard lock(mutex_);
 
   if (!closed_) {
-    data_.push_back(std::move(value));
+    if (size_ == data_.size()) {
+      Grow(std::max<size_t>(2U * data_.size(), 16U));
+    }
+
+    data_[(head_ + size_) % data_.size()] = std::move(value);
+    ++size_;
   }
 
   cv_not_empty_.notify_one();
@@ -47,20 +75,32 @@ template <typename T>
 std::optional<T> BlockingQueue<T>::Pop() {
   std::unique_lock lock(mutex_);
 
-  while (!closed_ && data_.empty()) {
+  while (!closed_ && size_ == 0U) {
     cv_not_empty_.wait(lock);
   }
 
-  if (closed_ && data_.empty()) {
+  if (closed_ && size_ == 0U) {
     return std::nullopt;
   }
 
-  T front{std::move(data_.front())};
-  data_.pop_front();
+  T front{std::move(data_[head_])};
+  head_ = (head_ + 1U) % data_.size();
+  --size_;
 
   return front;
 }
 
+template <typename T>
+void BlockingQueue<T>::Grow(size_t capacity) {
+  std::vector<T> data(capacity);
+  for (size_t i = 0U; i < size_; ++i) {
+    data[i] = std::move(data_[(head_ + i) % data_.size()]);
+  }
+
+  data_ = std::move(data);
+  head_ = 0U;
+}
+
 template <typename T>
 void BlockingQueue<T>::Close() {
   std::lock_guard lock(mutex_);
@@ -0,0 +1,138 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file InplaceFunction.hpp
+ * @date 2024-08-24
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ra::utils {
+
+template <typename Signature, size_t Capacity>
+class InplaceFunction;
+
+/**
+ * Move-only replacement of std::function, which stores the callable inside itself and never allocates. Callables
+ * larger than `Capacity` bytes don't compile, they should capture a pointer to their state instead.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+ public:
+  InplaceFunction() = default;
+
+  template <typename F>
+    requires(!std::is_same_v<std::decay_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  InplaceFunction(F&& callable);
+
+  InplaceFunction(InplaceFunction&& other) noexcept;
+  InplaceFunction& operator=(InplaceFunction&& other) noexcept;
+
+  InplaceFunction(const InplaceFunction&)            = delete;
+  InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+  ~InplaceFunction();
+
+  R operator()(Args... args);
+
+  explicit operator bool() const;
+
+ private:
+  using InvokeFunc   = R (*)(void* storage, Args&&... args);
+  using RelocateFunc = void (*)(void* to, void* from);  // Moves from `from` into `to` unless it's null, destroys `from`
+
+  void Reset();
+
+  alignas(std::max_align_t) std::byte storage_[Capacity];
+  InvokeFunc   invoke_{nullptr};
+  RelocateFunc relocate_{nullptr};
+};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename F>
+  requires(!std::is_same_v<std::decay_t<F>, InplaceFunction<R(Args...), Capacity>> &&
+           std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+InplaceFunction<R(Args...), Capacity>::InplaceFunction(F&& callable) {
+  using Callable = std::decay_t<F>;
+
+  static_assert(sizeof(Callable) <= Capacity, "Callable doesn't fit into InplaceFunction, capture less");
+  static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for InplaceFunction");
+  static_assert(std::is_nothrow_move_constructible_v<Callable>, "Callable must be nothrow move constructible");
+
+  new (storage_) Callable(std::forward<F>(callable));
+
+  invoke_ = [](void* storage, Args&&... args) -> R {
+    return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+  };
+
+  relocate_ = [](void* to, void* from) {
+    if (to != nullptr) {
+      new (to) Callable(std::move(*static_cast<Callable*>(from)));
+    }
+
+    static_cast<Callable*>(from)->~Callable();
+  };
+}
+
+template <typename R, typename... Args, size_t Capacity>
+InplaceFunction<R(Args...), Capacity>::InplaceFunction(InplaceFunction&& other) noexcept
+    : invoke_(other.invoke_), relocate_(other.relocate_) {
+  if (relocate_ != nullptr) {
+    relocate_(storage_, other.storage_);
+  }
+
+  other.invoke_   = nullptr;
+  other.relocate_ = nullptr;
+}
+
+template <typename R, typename... Args, size_t Capacity>
+InplaceFunction<R(Args...), Capacity>& InplaceFunction<R(Args...), Capacity>::operator=(
+    InplaceFunction&& other) noexcept {
+  if (this != &other) {
+    Reset();
+
+    invoke_   = other.invoke_;
+    relocate_ = other.relocate_;
+    if (relocate_ != nullptr) {
+      relocate_(storage_, other.storage_);
+    }
+
+    other.invoke_   = nullptr;
+    other.relocate_ = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename R, typename... Args, size_t Capacity>
+InplaceFunction<R(Args...), Capacity>::~InplaceFunction() {
+  Reset();
+}
+
+template <typename R, typename... Args, size_t Capacity>
+R InplaceFunction<R(Args...), Capacity>::operator()(Args... args) {
+  return invoke_(storage_, std::forward<Args>(args)...);
+}
+
+template <typename R, typename... Args, size_t Capacity>
+InplaceFunction<R(Args...), Capacity>::operator bool() const {
+  return invoke_ != nullptr;
+}
+
+template <typename R, typename... Args, size_t Capacity>
+void InplaceFunction<R(Args...), Capacity>::Reset() {
+  if (relocate_ != nullptr) {
+    relocate_(nullptr, storage_);
+  }
+
+  invoke_   = nullptr;
+  relocate_ = nullptr;
+}
+
+}  // namespace ra::utils
@@ -8,25 +8,101 @@
 
 #include <Utils/Random.hpp>
 
+#include <random>
+
 namespace ra::utils {
 
-Random Random::instance_;
+static constexpr uint32_t RotateLeft(uint32_t value, uint32_t shift) {
+  return (value << shift) | (value >> (32U - shift));
+}
+
+/**
+ * Converts upper 24 bits of `value` into a float in [0, 1).
+ */
+static constexpr float ToNormalized(uint32_t value) {
+  return static_cast<float>(value >> 8U) * (1.0f / 16777216.0f);
+}
+
+/**
+ * Recommended way of seeding xoshiro generators, see https://prng.di.unimi.it/splitmix64.c
+ */
+static uint64_t SplitMix64(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z          = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z          = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+inline uint32_t Random::Step(size_t lane) {
+  const uint32_t result = state_[0U][lane] + state_[3U][lane];
+  const uint32_t t      = state_[1U][lane] << 9U;
+
+  state_[2U][lane] ^= state_[0U][lane];
+  state_[3U][lane] ^= state_[1U][lane];
+  state_[1U][lane] ^= state_[2U][lane];
+  state_[0U][lane] ^= state_[3U][lane];
+  state_[2U][lane] ^= t;
+  state_[3U][lane] = RotateLeft(state_[3U][lane], 11U);
+
+  return result;
+}
+
+Random& Random::Instance() {
+  thread_local Random instance{std::random_device{}()};
+  return instance;
+}
+
+Random::Random(uint64_t seed) {
+  Seed(seed);
+}
 
-Random& Random::Instance() { return instance_; }
+void Random::Seed(uint64_t seed) {
+  uint64_t splitmix_state = seed;
 
-Random::Random() : generator_(device_()) {}
+  for (size_t lane = 0U; lane < kLanes; ++lane) {
+    const uint64_t first  = SplitMix64(splitmix_state);
+    const uint64_t second = SplitMix64(splitmix_state);
+
+    state_[0U][lane] = static_cast<uint32_t>(first);
+    state_[1U][lane] = static_cast<uint32_t>(first >> 32U);
+    state_[2U][lane] = static_cast<uint32_t>(second);
+    state_[3U][lane] = static_cast<uint32_t>(second >> 32U);
+  }
+
+  next_lane_ = 0U;
+}
 
 float Random::Normalized() {
-  return InRange(0.0f, 1.0f);
+  return ToNormalized(NextLane());
 }
 
 float Random::InRange(float start, float end) {
-  std::uniform_real_distribution<float> dist(start, end);
-  return dist(generator_);
+  return start + (end - start) * Normalized();
 }
 
 math::Vec2f Random::InRange(const math::Vec2f& start, const math::Vec2f& end) {
   return math::Vec2f(InRange(start.x, end.x), InRange(start.y, end.y));
 }
 
-}  // namespace ra::utils
\ No newline at end of file
+void Random::FillNormalized(std::span<float> values) {
+  size_t i = 0U;
+
+  for (; i + kLanes <= values.size(); i += kLanes) {
+    for (size_t lane = 0U; lane < kLanes; ++lane) {
+      values[i + lane] = ToNormalized(Step(lane));
+    }
+  }
+
+  for (; i < values.size(); ++i) {
+    values[i] = Normalized();
+  }
+}
+
+uint32_t Random::NextLane() {
+  const size_t lane = next_lane_;
+  next_lane_        = (next_lane_ + 1U) % kLanes;
+
+  return Step(lane);
+}
+
+}  // namespace ra::utils
@@ -10,25 +10,46 @@
 
 #include <Math/Vec2.hpp>
 
-#include <random>
+#include <span>
 
 namespace ra::utils {
 
+/**
+ * Fast non-cryptographic random generator based on xoshiro128+ (https://prng.di.unimi.it).
+ *
+ * The generator runs kLanes independent xoshiro128+ streams, whose state is stored lane-wise, so that bulk generation
+ * (see FillNormalized) steps all lanes at once and vectorizes. Single values are taken from the lanes in turn.
+ *
+ * Each thread has its own generator instance, so no synchronization is needed.
+ */
 class Random {
  public:
+  /**
+   * @return Generator of the calling thread.
+   */
   static Random& Instance();
 
+  explicit Random(uint64_t seed);
+
+  void Seed(uint64_t seed);
+
   float Normalized();
   float InRange(float start, float end);
   math::Vec2f InRange(const math::Vec2f& start, const math::Vec2f& end);
 
+  /**
+   * Fills `values` with uniformly distributed numbers in [0, 1).
+   */
+  void FillNormalized(std::span<float> values);
+
  private:
-  Random();
+  static constexpr size_t kLanes = 8U;
 
-  std::random_device device_;
-  std::mt19937       generator_;
+  uint32_t NextLane();
+  uint32_t Step(size_t lane);
 
-  static Random instance_;
+  uint32_t state_[4U][kLanes];
+  size_t   next_lane_{0U};
 };
 
-}  // namespace ra::utils
\ No newline at end of file
+}  // namespace ra::utils
@@ -0,0 +1,34 @@
+/**
+ * @author Nikita Mochalov (github.com/tralf-strues)
+ * @file TypeName.hpp
+ * @date 2024-08-22
+ *
+ * @copyright Copyright (c) 2024
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace ra::utils {
+
+/**
+ * Name of the type without the project's namespace, e.g. "render::ParticleSystem", as spelled by the compiler in the
+ * function's signature (GCC and Clang). Meant for reports and logs only.
+ */
+template <typename T>
+constexpr std::string_view TypeName() {
+  constexpr std::string_view kSignature = __PRETTY_FUNCTION__;
+  constexpr std::string_view kPrefix    = "T = ";
+
+  auto name = kSignature.substr(kSignature.find(kPrefix) + kPrefix.size());
+  name      = name.substr(0U, name.find_first_of(";]"));
+
+  if (name.starts_with("ra::")) {
+    name.remove_prefix(4U);
+  }
+
+  return name;
+}
+
+}  // namespace ra::utils
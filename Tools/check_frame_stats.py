@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+Checks tail latency of a headless run against fixed limits. Input file is written by
+`retro-asteroids-headless --frame-stats JSON`.
+
+Usage: check_frame_stats.py STATS.json [--stage frame] [--max-p99-ms BUDGET] [--max-hitches 0]
+
+Exits with 1 if the p99 of the stage exceeds the limit (the frame budget by default) or if there are more hitches, i.e.
+frames longer than twice the budget, than allowed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check tail latency of a headless run")
+    parser.add_argument("stats")
+    parser.add_argument("--stage", default="frame", help="frame, update or render")
+    parser.add_argument("--max-p99-ms", type=float, default=None, help="p99 limit, the frame budget by default")
+    parser.add_argument("--max-hitches", type=int, default=0, help="allowed number of hitches")
+    args = parser.parse_args()
+
+    with open(args.stats) as f:
+        stats = json.load(f)
+
+    stage = stats[args.stage]
+    max_p99_ms = args.max_p99_ms if args.max_p99_ms is not None else stats["budget_ms"]
+
+    print(f"{args.stage}, ms     {'mean':>10} {'p50':>10} {'p95':>10} {'p99':>10} {'max':>10}")
+    print(f"{'':<14} {stage['mean_ms']:10.3f} {stage['p50_ms']:10.3f} {stage['p95_ms']:10.3f} "
+          f"{stage['p99_ms']:10.3f} {stage['max_ms']:10.3f}")
+    print(f"hitches (> {stats['hitch_threshold_ms']:.2f} ms): {stats['hitches']}")
+
+    failed = False
+    if stage["p99_ms"] > max_p99_ms:
+        print(f"p99 of {args.stage} is over {max_p99_ms:.3f} ms")
+        failed = True
+
+    if stats["hitches"] > args.max_hitches:
+        print(f"More than {args.max_hitches} hitches")
+        failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
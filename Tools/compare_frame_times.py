@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Compares frame time distributions of two headless runs, e.g. of a base and a changed build replaying the same input
+recording. Input files are written by `retro-asteroids-headless --frame-times CSV`.
+
+Usage: compare_frame_times.py BASE.csv HEAD.csv [--column frame_ns] [--warmup 60] [--threshold 0.10]
+
+Exits with 1 if the median or p99 of HEAD is slower than BASE by more than the threshold.
+"""
+
+import argparse
+import csv
+import sys
+
+
+def load(path, column, warmup):
+    with open(path, newline="") as f:
+        values = [float(row[column]) for row in csv.DictReader(f)]
+
+    return sorted(values[warmup:])
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, int(p * len(values)))]
+
+
+def summary(values):
+    return {
+        "mean": sum(values) / len(values),
+        "p50": percentile(values, 0.50),
+        "p90": percentile(values, 0.90),
+        "p99": percentile(values, 0.99),
+        "max": values[-1],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare frame time distributions of two headless runs")
+    parser.add_argument("base")
+    parser.add_argument("head")
+    parser.add_argument("--column", default="frame_ns", help="act_ns, draw_ns or frame_ns")
+    parser.add_argument("--warmup", type=int, default=60, help="frames skipped at the start of each run")
+    parser.add_argument("--threshold", type=float, default=0.10, help="allowed relative slowdown of p50 and p99")
+    args = parser.parse_args()
+
+    base = load(args.base, args.column, args.warmup)
+    head = load(args.head, args.column, args.warmup)
+
+    if len(base) != len(head):
+        print(f"warning: runs have different frame counts ({len(base)} vs {len(head)}), workloads may differ")
+
+    base_summary = summary(base)
+    head_summary = summary(head)
+
+    print(f"{args.column}, ms     {'base':>10} {'head':>10} {'change':>10}")
+
+    regressed = False
+    for stat in base_summary:
+        change = head_summary[stat] / base_summary[stat] - 1.0
+        print(f"{stat:<14} {base_summary[stat] * 1e-6:10.3f} {head_summary[stat] * 1e-6:10.3f} {change * 100.0:+9.1f}%")
+
+        if stat in ("p50", "p99") and change > args.threshold:
+            regressed = True
+
+    if regressed:
+        print(f"Frame times regressed by more than {args.threshold * 100.0:.0f}%")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())